@@ -2,6 +2,8 @@
 
 export module Eqx.OGL.Buffer;
 
+import Eqx.OGL.Gpu_Memory;
+
 import <Eqx/std.hpp>;
 import <Eqx/TPL/glad/glad.hpp>;
 
@@ -93,6 +95,8 @@ export namespace eqx::ogl
             this->enable();
             glBufferData(t_buffer, std::ranges::size(data) * sizeof(float),
                 data.data(), GL_STATIC_DRAW);
+            Gpu_Memory::track(Buffer::c_category, this->m_id,
+                std::ranges::size(data) * sizeof(float));
         }
 
         inline void buffer_data(
@@ -105,6 +109,13 @@ export namespace eqx::ogl
             glBufferData(t_buffer,
                 std::ranges::size(data) * sizeof(unsigned int), data.data(),
                 GL_STATIC_DRAW);
+            Gpu_Memory::track(Buffer::c_category, this->m_id,
+                std::ranges::size(data) * sizeof(unsigned int));
+        }
+
+        [[nodiscard]] inline std::size_t get_bytes() const noexcept
+        {
+            return Gpu_Memory::get_bytes(Buffer::c_category, this->m_id);
         }
 
         [[nodiscard]] constexpr GLuint get_id() const noexcept
@@ -121,6 +132,7 @@ export namespace eqx::ogl
         {
             assert(this->valid());
 
+            Gpu_Memory::untrack(Buffer::c_category, this->m_id);
             glDeleteBuffers(1, &m_id);
             this->m_id = 0u;
 
@@ -128,6 +140,10 @@ export namespace eqx::ogl
         }
 
     private:
+        static constexpr auto c_category = t_buffer == GL_ARRAY_BUFFER
+            ? Gpu_Memory::Category::Vertex_Buffer
+            : Gpu_Memory::Category::Index_Buffer;
+
         GLuint m_id;
     };
 
@@ -0,0 +1,115 @@
+// Frame_Limiter.cpp
+
+export module Eqx.OGL.Frame_Limiter;
+
+import <Eqx/std.hpp>;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    /*
+     * Holds a loop to an exact frame period. wait() sleeps until shortly
+     * before the deadline and spins the rest, the sleep margin follows the
+     * measured oversleep of the OS scheduler so the spin stays short. A rate
+     * of 0 disables limiting. Deadlines advance by whole periods, a frame
+     * that overruns by more than a period resynchronises instead of
+     * bursting to catch up.
+     */
+    class Frame_Limiter
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        Frame_Limiter(const Frame_Limiter&) = default;
+        Frame_Limiter(Frame_Limiter&&) = default;
+        Frame_Limiter& operator= (const Frame_Limiter&) = default;
+        Frame_Limiter& operator= (Frame_Limiter&&) = default;
+        ~Frame_Limiter() = default;
+
+        explicit inline Frame_Limiter(const float hz = 60.0F) noexcept
+            :
+            m_period(Clock::duration::zero()),
+            m_deadline(Clock::now()),
+            m_oversleep(std::chrono::duration<double>{ 1ms }),
+            m_missed(0ull)
+        {
+            this->set_rate(hz);
+        }
+
+        inline void wait() noexcept
+        {
+            if (this->m_period == Clock::duration::zero())
+            {
+                return;
+            }
+
+            const auto now = Clock::now();
+            if (now > this->m_deadline + this->m_period) [[unlikely]]
+            {
+                this->m_deadline = now + this->m_period;
+                ++this->m_missed;
+                return;
+            }
+
+            const auto margin = this->get_margin();
+            if (this->m_deadline - now > margin)
+            {
+                const auto target = this->m_deadline - margin;
+                std::this_thread::sleep_until(target);
+
+                const auto error =
+                    std::chrono::duration<double>{ Clock::now() - target };
+                this->m_oversleep = this->m_oversleep * 0.875 + error * 0.125;
+            }
+
+            while (Clock::now() < this->m_deadline)
+            {
+            }
+
+            this->m_deadline += this->m_period;
+        }
+
+        inline void set_rate(const float hz) noexcept
+        {
+            assert(hz >= 0.0F);
+
+            this->m_period = hz == 0.0F
+                ? Clock::duration::zero()
+                : std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>{ 1.0 / hz });
+            this->m_deadline = Clock::now() + this->m_period;
+        }
+
+        [[nodiscard]] inline float get_rate() const noexcept
+        {
+            return this->m_period == Clock::duration::zero()
+                ? 0.0F
+                : static_cast<float>(1.0 / std::chrono::duration<double>{
+                    this->m_period }.count());
+        }
+
+        /*
+         * How long before a deadline wait() stops sleeping and starts
+         * spinning.
+         */
+        [[nodiscard]] inline Clock::duration get_margin() const noexcept
+        {
+            return std::clamp(
+                std::chrono::duration_cast<Clock::duration>(
+                    this->m_oversleep * 1.5),
+                Clock::duration{ 100us }, Clock::duration{ 4ms });
+        }
+
+        [[nodiscard]] constexpr unsigned long long get_missed() const noexcept
+        {
+            return this->m_missed;
+        }
+
+    private:
+        Clock::duration m_period;
+        Clock::time_point m_deadline;
+        std::chrono::duration<double> m_oversleep;
+        unsigned long long m_missed;
+    };
+}
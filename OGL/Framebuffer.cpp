@@ -0,0 +1,570 @@
+// Framebuffer.cpp
+
+export module Eqx.OGL.Framebuffer;
+
+import Eqx.OGL.Gpu_Memory;
+import Eqx.OGL.Texture;
+import Eqx.OGL.Window;
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glad/glad.hpp>;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    static_assert(std::same_as<GLuint, unsigned int>);
+    static_assert(std::same_as<GLenum, unsigned int>);
+
+    class Renderbuffer
+    {
+    public:
+        Renderbuffer(const Renderbuffer&) = delete;
+        Renderbuffer& operator= (const Renderbuffer&) = delete;
+
+        explicit constexpr Renderbuffer() noexcept
+            :
+            m_id(0u),
+            m_width(0),
+            m_height(0),
+            m_format(0u),
+            m_samples(0)
+        {
+        }
+
+        explicit inline Renderbuffer(const int width, const int height,
+            const GLenum format, const int samples = 0) noexcept
+            :
+            Renderbuffer()
+        {
+            this->init(width, height, format, samples);
+        }
+
+        constexpr Renderbuffer(Renderbuffer&& other) noexcept
+            :
+            m_id(std::exchange(other.m_id, 0u)),
+            m_width(other.m_width),
+            m_height(other.m_height),
+            m_format(other.m_format),
+            m_samples(other.m_samples)
+        {
+        }
+
+        constexpr Renderbuffer& operator= (Renderbuffer&& other) noexcept
+        {
+            std::swap(this->m_id, other.m_id);
+            std::swap(this->m_width, other.m_width);
+            std::swap(this->m_height, other.m_height);
+            std::swap(this->m_format, other.m_format);
+            std::swap(this->m_samples, other.m_samples);
+            return *this;
+        }
+
+        constexpr ~Renderbuffer() noexcept
+        {
+            if (this->valid()) [[likely]]
+            {
+                this->free();
+            }
+        }
+
+        /*
+         * samples 0 is a plain renderbuffer, anything above is multisampled
+         * and must be resolved with Framebuffer::blit before being read.
+         */
+        inline void init(const int width, const int height,
+            const GLenum format, const int samples = 0) noexcept
+        {
+            assert(!this->valid());
+            assert(width > 0 && height > 0);
+            assert(samples >= 0);
+
+            glGenRenderbuffers(1, &this->m_id);
+            assert(this->valid());
+
+            glBindRenderbuffer(GL_RENDERBUFFER, this->m_id);
+            glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, format,
+                width, height);
+            glBindRenderbuffer(GL_RENDERBUFFER, 0u);
+
+            this->m_width = width;
+            this->m_height = height;
+            this->m_format = format;
+            this->m_samples = samples;
+
+            Gpu_Memory::track(Gpu_Memory::Category::Render_Target, this->m_id,
+                static_cast<std::size_t>(width * height
+                    * Renderbuffer::bytes_per_sample(format)
+                    * std::max(samples, 1)));
+        }
+
+        [[nodiscard]] constexpr bool depth() const noexcept
+        {
+            return this->m_format == GL_DEPTH24_STENCIL8
+                || this->m_format == GL_DEPTH32F_STENCIL8
+                || this->m_format == GL_DEPTH_COMPONENT16
+                || this->m_format == GL_DEPTH_COMPONENT24
+                || this->m_format == GL_DEPTH_COMPONENT32F;
+        }
+
+        [[nodiscard]] constexpr bool stencil() const noexcept
+        {
+            return this->m_format == GL_DEPTH24_STENCIL8
+                || this->m_format == GL_DEPTH32F_STENCIL8;
+        }
+
+        [[nodiscard]] constexpr GLuint get_id() const noexcept
+        {
+            return this->m_id;
+        }
+
+        [[nodiscard]] constexpr int get_width() const noexcept
+        {
+            return this->m_width;
+        }
+
+        [[nodiscard]] constexpr int get_height() const noexcept
+        {
+            return this->m_height;
+        }
+
+        [[nodiscard]] constexpr GLenum get_format() const noexcept
+        {
+            return this->m_format;
+        }
+
+        [[nodiscard]] constexpr int get_samples() const noexcept
+        {
+            return this->m_samples;
+        }
+
+        [[nodiscard]] inline std::size_t get_bytes() const noexcept
+        {
+            return Gpu_Memory::get_bytes(Gpu_Memory::Category::Render_Target,
+                this->m_id);
+        }
+
+        [[nodiscard]] constexpr bool valid() const noexcept
+        {
+            return this->m_id != 0u;
+        }
+
+        inline void free() noexcept
+        {
+            assert(this->valid());
+
+            Gpu_Memory::untrack(Gpu_Memory::Category::Render_Target,
+                this->m_id);
+            glDeleteRenderbuffers(1, &this->m_id);
+            this->m_id = 0u;
+
+            assert(!this->valid());
+        }
+
+    private:
+        [[nodiscard]] static constexpr int bytes_per_sample(
+            const GLenum format) noexcept
+        {
+            switch (format)
+            {
+            case GL_R8:
+                return 1;
+            case GL_DEPTH_COMPONENT16:
+                return 2;
+            case GL_RGBA16F:
+            case GL_DEPTH32F_STENCIL8:
+                return 8;
+            case GL_RGBA32F:
+                return 16;
+            default:
+                return 4;
+            }
+        }
+
+        GLuint m_id;
+        int m_width;
+        int m_height;
+        GLenum m_format;
+        int m_samples;
+    };
+
+    class Framebuffer
+    {
+    public:
+        Framebuffer(const Framebuffer&) = delete;
+        Framebuffer& operator= (const Framebuffer&) = delete;
+
+        explicit constexpr Framebuffer() noexcept
+            :
+            m_id(0u),
+            m_width(0),
+            m_height(0)
+        {
+        }
+
+        constexpr Framebuffer(Framebuffer&& other) noexcept
+            :
+            m_id(std::exchange(other.m_id, 0u)),
+            m_width(other.m_width),
+            m_height(other.m_height)
+        {
+        }
+
+        constexpr Framebuffer& operator= (Framebuffer&& other) noexcept
+        {
+            std::swap(this->m_id, other.m_id);
+            std::swap(this->m_width, other.m_width);
+            std::swap(this->m_height, other.m_height);
+            return *this;
+        }
+
+        constexpr ~Framebuffer() noexcept
+        {
+            if (this->valid()) [[likely]]
+            {
+                this->free();
+            }
+        }
+
+        inline void init() noexcept
+        {
+            assert(!this->valid());
+
+            glGenFramebuffers(1, &this->m_id);
+
+            assert(this->valid());
+        }
+
+        // Leaves the framebuffer bound.
+        inline void attach_color(const Renderbuffer& renderbuffer,
+            const int i = 0) noexcept
+        {
+            assert(!renderbuffer.depth());
+
+            this->attach(GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i),
+                renderbuffer);
+        }
+
+        // Textures do not know their size, it must match the other ones.
+        inline void attach_color(const Texture& texture, const int width,
+            const int height, const int i = 0) noexcept
+        {
+            assert(texture.valid());
+
+            this->bind_attachment(width, height);
+            glFramebufferTexture2D(GL_FRAMEBUFFER,
+                GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(i), GL_TEXTURE_2D,
+                texture.get_id(), 0);
+        }
+
+        inline void attach_depth(const Renderbuffer& renderbuffer) noexcept
+        {
+            assert(renderbuffer.depth());
+
+            this->attach(renderbuffer.stencil()
+                ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT,
+                renderbuffer);
+        }
+
+        [[nodiscard]] inline bool complete() const noexcept
+        {
+            assert(this->valid());
+
+            glBindFramebuffer(GL_FRAMEBUFFER, this->m_id);
+            return glCheckFramebufferStatus(GL_FRAMEBUFFER)
+                == GL_FRAMEBUFFER_COMPLETE;
+        }
+
+        // Binds for drawing and reading and matches the viewport.
+        inline void enable() const noexcept
+        {
+            assert(this->valid());
+
+            glBindFramebuffer(GL_FRAMEBUFFER, this->m_id);
+            glViewport(0, 0, this->m_width, this->m_height);
+        }
+
+        /*
+         * Returns to the framebuffer the window presents, which is not 0
+         * when headless, and restores its viewport.
+         */
+        inline void disable(const Window& window) const noexcept
+        {
+            assert(this->valid());
+
+            const auto [width, height] = window.get_framebuffer_size();
+            glBindFramebuffer(GL_FRAMEBUFFER, window.get_framebuffer());
+            glViewport(0, 0, width, height);
+        }
+
+        /*
+         * Copies into another framebuffer, resolving multisampled
+         * attachments on the way. A multisample resolve needs matching
+         * sizes, anything else may scale with GL_LINEAR on color.
+         */
+        inline void blit(const Framebuffer& target,
+            const GLbitfield mask = GL_COLOR_BUFFER_BIT,
+            const GLenum filter = GL_NEAREST) const noexcept
+        {
+            assert(target.valid());
+
+            this->blit(target.m_id, target.m_width, target.m_height, mask,
+                filter);
+        }
+
+        inline void blit(const Window& window,
+            const GLbitfield mask = GL_COLOR_BUFFER_BIT,
+            const GLenum filter = GL_NEAREST) const noexcept
+        {
+            const auto [width, height] = window.get_framebuffer_size();
+            this->blit(window.get_framebuffer(), width, height, mask, filter);
+        }
+
+        [[nodiscard]] constexpr GLuint get_id() const noexcept
+        {
+            return this->m_id;
+        }
+
+        [[nodiscard]] constexpr int get_width() const noexcept
+        {
+            return this->m_width;
+        }
+
+        [[nodiscard]] constexpr int get_height() const noexcept
+        {
+            return this->m_height;
+        }
+
+        [[nodiscard]] constexpr bool valid() const noexcept
+        {
+            return this->m_id != 0u;
+        }
+
+        inline void free() noexcept
+        {
+            assert(this->valid());
+
+            glDeleteFramebuffers(1, &this->m_id);
+            this->m_id = 0u;
+            this->m_width = 0;
+            this->m_height = 0;
+
+            assert(!this->valid());
+        }
+
+    private:
+        inline void attach(const GLenum attachment,
+            const Renderbuffer& renderbuffer) noexcept
+        {
+            assert(renderbuffer.valid());
+
+            this->bind_attachment(renderbuffer.get_width(),
+                renderbuffer.get_height());
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, attachment,
+                GL_RENDERBUFFER, renderbuffer.get_id());
+        }
+
+        inline void bind_attachment(const int width, const int height) noexcept
+        {
+            assert(this->valid());
+            assert(this->m_width == 0
+                || (this->m_width == width && this->m_height == height));
+
+            glBindFramebuffer(GL_FRAMEBUFFER, this->m_id);
+            this->m_width = width;
+            this->m_height = height;
+        }
+
+        inline void blit(const GLuint target, const int width,
+            const int height, const GLbitfield mask,
+            const GLenum filter) const noexcept
+        {
+            assert(this->valid());
+
+            auto read = GLint{ 0 };
+            auto draw = GLint{ 0 };
+            glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read);
+            glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw);
+
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, this->m_id);
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target);
+            glBlitFramebuffer(0, 0, this->m_width, this->m_height,
+                0, 0, width, height, mask, filter);
+
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, static_cast<GLuint>(read));
+            glBindFramebuffer(GL_DRAW_FRAMEBUFFER, static_cast<GLuint>(draw));
+        }
+
+        GLuint m_id;
+        int m_width;
+        int m_height;
+    };
+
+    /*
+     * A width or height of 0 follows the window's framebuffer size, at
+     * least 1x1 so a minimized window still gets a valid target. depth 0
+     * means no depth attachment.
+     */
+    struct Render_Target_Desc
+    {
+        int width;
+        int height;
+        GLenum color;
+        GLenum depth;
+        int samples;
+
+        constexpr bool operator== (const Render_Target_Desc&) const = default;
+    };
+
+    struct Render_Target
+    {
+        Render_Target_Desc desc;
+        Framebuffer framebuffer;
+        Renderbuffer color;
+        Renderbuffer depth;
+    };
+
+    /*
+     * Transient render targets reused across frames.
+     *
+     * acquire() hands out a free target whose resolved description matches
+     * or creates one, everything acquired is released again by new_frame().
+     * Targets unused for c_max_idle frames are freed, and when the window's
+     * framebuffer size changes every target that follows it is dropped so
+     * the next acquire() allocates at the new size. References stay valid
+     * until then.
+     */
+    class Render_Target_Pool
+    {
+    public:
+        static constexpr auto c_max_idle = 60ull;
+
+        Render_Target_Pool(const Render_Target_Pool&) = delete;
+        Render_Target_Pool& operator= (const Render_Target_Pool&) = delete;
+        Render_Target_Pool(Render_Target_Pool&&) = default;
+        Render_Target_Pool& operator= (Render_Target_Pool&&) = default;
+        ~Render_Target_Pool() = default;
+
+        explicit inline Render_Target_Pool(const Window& window) noexcept
+            :
+            m_window(&window),
+            m_size(window.get_framebuffer_size()),
+            m_entries(),
+            m_frame(0ull),
+            m_allocations(0ull)
+        {
+        }
+
+        [[nodiscard]] inline Render_Target& acquire(
+            const Render_Target_Desc& desc) noexcept
+        {
+            const auto resolved = this->resolve(desc);
+            for (auto& entry : this->m_entries)
+            {
+                if (!entry->in_use && entry->target.desc == resolved)
+                {
+                    entry->in_use = true;
+                    entry->last_used = this->m_frame;
+                    return entry->target;
+                }
+            }
+
+            auto& entry = *this->m_entries.emplace_back(
+                std::make_unique<Entry>());
+            entry.in_use = true;
+            entry.last_used = this->m_frame;
+            entry.follows_window = desc.width == 0 || desc.height == 0;
+
+            auto& target = entry.target;
+            target.desc = resolved;
+            target.framebuffer.init();
+            target.color.init(resolved.width, resolved.height, resolved.color,
+                resolved.samples);
+            target.framebuffer.attach_color(target.color);
+            if (resolved.depth != 0u)
+            {
+                target.depth.init(resolved.width, resolved.height,
+                    resolved.depth, resolved.samples);
+                target.framebuffer.attach_depth(target.depth);
+            }
+            assert(target.framebuffer.complete());
+            target.framebuffer.disable(*this->m_window);
+
+            ++this->m_allocations;
+            return target;
+        }
+
+        inline void release(const Render_Target& target) noexcept
+        {
+            const auto it = std::ranges::find_if(this->m_entries,
+                [&target](const std::unique_ptr<Entry>& entry) noexcept
+                {
+                    return &entry->target == &target;
+                });
+            assert(it != std::ranges::end(this->m_entries));
+
+            (*it)->in_use = false;
+        }
+
+        inline void new_frame() noexcept
+        {
+            ++this->m_frame;
+
+            const auto size = this->m_window->get_framebuffer_size();
+            const auto resized = size != this->m_size;
+            this->m_size = size;
+
+            std::erase_if(this->m_entries,
+                [this, resized](const std::unique_ptr<Entry>& entry) noexcept
+                {
+                    return (resized && entry->follows_window)
+                        || this->m_frame - entry->last_used > c_max_idle;
+                });
+
+            for (auto& entry : this->m_entries)
+            {
+                entry->in_use = false;
+            }
+        }
+
+        [[nodiscard]] inline std::size_t get_count() const noexcept
+        {
+            return std::ranges::size(this->m_entries);
+        }
+
+        // Targets created since construction, reuse keeps this flat.
+        [[nodiscard]] constexpr unsigned long long
+            get_allocations() const noexcept
+        {
+            return this->m_allocations;
+        }
+
+    private:
+        struct Entry
+        {
+            Render_Target target;
+            bool in_use;
+            bool follows_window;
+            unsigned long long last_used;
+        };
+
+        [[nodiscard]] inline Render_Target_Desc resolve(
+            Render_Target_Desc desc) const noexcept
+        {
+            // A minimized window reports 0x0.
+            if (desc.width == 0 || desc.height == 0)
+            {
+                desc.width = std::max(this->m_size.first, 1);
+                desc.height = std::max(this->m_size.second, 1);
+            }
+
+            return desc;
+        }
+
+        const Window* m_window;
+        std::pair<int, int> m_size;
+        std::vector<std::unique_ptr<Entry>> m_entries;
+        unsigned long long m_frame;
+        unsigned long long m_allocations;
+    };
+}
@@ -0,0 +1,350 @@
+// Gpu_Memory.cpp
+
+export module Eqx.OGL.Gpu_Memory;
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glad/glad.hpp>;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    static_assert(std::same_as<GLuint, unsigned int>);
+
+    /*
+     * Registry of the estimated GPU footprint of every live resource.
+     *
+     * Resources are keyed by category and GL name, so moving the owning
+     * wrapper around does not invalidate its entry. Evictable textures keep
+     * their GL name when evicted, only the storage is released, and they are
+     * reloaded transparently the next time they are bound, outside the
+     * registry lock. Every function locks the registry, so contexts sharing
+     * objects with the main one, such as an Upload_Worker's, may track
+     * resources too. Such threads call defer_eviction(true) first, evicting
+     * from there would redefine textures the main context may be sampling
+     * without any synchronization, and the main thread enforces the budget
+     * later through enforce_budget().
+     */
+    class Gpu_Memory
+    {
+    public:
+        enum class Category : std::uint32_t
+        {
+            Texture = 0u,
+            Vertex_Buffer = 1u,
+            Index_Buffer = 2u,
+            Render_Target = 3u
+        };
+
+        Gpu_Memory() = delete;
+        Gpu_Memory(const Gpu_Memory&) = delete;
+        Gpu_Memory(Gpu_Memory&&) = delete;
+        Gpu_Memory& operator= (const Gpu_Memory&) = delete;
+        Gpu_Memory& operator= (Gpu_Memory&&) = delete;
+        ~Gpu_Memory() = delete;
+
+        static inline void track(const Category category, const GLuint id,
+            const std::size_t bytes) noexcept
+        {
+            const auto lock = std::scoped_lock{ s_mutex };
+
+            auto& entry = s_entries[Gpu_Memory::key(category, id)];
+            Gpu_Memory::subtract(category, entry);
+
+            entry.bytes = bytes;
+            entry.last_bound = ++s_tick;
+            entry.resident = true;
+            entry.reloading = false;
+            Gpu_Memory::add(category, entry);
+
+            Gpu_Memory::enforce();
+        }
+
+        static inline void untrack(const Category category,
+            const GLuint id) noexcept
+        {
+            const auto lock = std::scoped_lock{ s_mutex };
+
+            const auto it = s_entries.find(Gpu_Memory::key(category, id));
+            if (it != std::ranges::end(s_entries))
+            {
+                Gpu_Memory::subtract(category, it->second);
+                s_entries.erase(it);
+            }
+        }
+
+        static inline void set_reload(const GLuint id,
+            std::function<void()> reload) noexcept
+        {
+            const auto lock = std::scoped_lock{ s_mutex };
+
+            const auto it =
+                s_entries.find(Gpu_Memory::key(Category::Texture, id));
+            assert(it != std::ranges::end(s_entries));
+
+            it->second.reload = std::move(reload);
+        }
+
+        static inline void set_evictable(const GLuint id,
+            const bool evictable) noexcept
+        {
+            const auto lock = std::scoped_lock{ s_mutex };
+
+            const auto it =
+                s_entries.find(Gpu_Memory::key(Category::Texture, id));
+            assert(it != std::ranges::end(s_entries));
+            assert(!evictable || it->second.reload);
+
+            it->second.evictable = evictable;
+
+            Gpu_Memory::enforce();
+        }
+
+        // Resident entries cost a single lookup. An evicted one is marked as
+        // reloading and reloaded with the registry unlocked, so other
+        // threads tracking resources are not held up by the decode and
+        // upload, then it is counted again once the lock is retaken.
+        static inline void bind(const Category category,
+            const GLuint id) noexcept
+        {
+            auto lock = std::unique_lock{ s_mutex };
+
+            const auto it = s_entries.find(Gpu_Memory::key(category, id));
+            if (it == std::ranges::end(s_entries)) [[unlikely]]
+            {
+                return;
+            }
+
+            it->second.last_bound = ++s_tick;
+
+            if (it->second.resident || it->second.reloading) [[likely]]
+            {
+                return;
+            }
+
+            it->second.reloading = true;
+            const auto reload = it->second.reload;
+
+            lock.unlock();
+            reload();
+            lock.lock();
+
+            // The entry may have been untracked, or tracked afresh, while
+            // the registry was unlocked.
+            const auto reloaded = s_entries.find(Gpu_Memory::key(category, id));
+            if (reloaded == std::ranges::end(s_entries)
+                || !reloaded->second.reloading)
+            {
+                return;
+            }
+
+            reloaded->second.reloading = false;
+            reloaded->second.resident = true;
+            reloaded->second.last_bound = ++s_tick;
+            Gpu_Memory::add(category, reloaded->second);
+            ++s_reloads;
+
+            Gpu_Memory::enforce();
+        }
+
+        // Only affects the calling thread.
+        static inline void defer_eviction(const bool defer) noexcept
+        {
+            s_defer = defer;
+        }
+
+        // Evicts down to the budget, for tracking deferred by other threads.
+        static inline void enforce_budget() noexcept
+        {
+            const auto lock = std::scoped_lock{ s_mutex };
+
+            Gpu_Memory::enforce();
+        }
+
+        static inline void set_budget(const std::size_t bytes) noexcept
+        {
+            const auto lock = std::scoped_lock{ s_mutex };
+
+            s_budget = bytes;
+
+            Gpu_Memory::enforce();
+        }
+
+        [[nodiscard]] static inline std::size_t get_budget() noexcept
+        {
+            const auto lock = std::scoped_lock{ s_mutex };
+
+            return s_budget;
+        }
+
+        [[nodiscard]] static inline std::size_t get_total() noexcept
+        {
+            const auto lock = std::scoped_lock{ s_mutex };
+
+            return std::reduce(std::ranges::begin(s_totals),
+                std::ranges::end(s_totals));
+        }
+
+        [[nodiscard]] static inline std::size_t get_total(
+            const Category category) noexcept
+        {
+            const auto lock = std::scoped_lock{ s_mutex };
+
+            return s_totals[static_cast<std::size_t>(category)];
+        }
+
+        [[nodiscard]] static inline std::size_t get_bytes(
+            const Category category, const GLuint id) noexcept
+        {
+            const auto lock = std::scoped_lock{ s_mutex };
+
+            const auto it = s_entries.find(Gpu_Memory::key(category, id));
+            return it == std::ranges::end(s_entries) || !it->second.resident
+                ? 0ull : it->second.bytes;
+        }
+
+        [[nodiscard]] static inline unsigned long long
+            get_evictions() noexcept
+        {
+            const auto lock = std::scoped_lock{ s_mutex };
+
+            return s_evictions;
+        }
+
+        [[nodiscard]] static inline unsigned long long get_reloads() noexcept
+        {
+            const auto lock = std::scoped_lock{ s_mutex };
+
+            return s_reloads;
+        }
+
+        [[nodiscard]] static constexpr std::size_t texture_bytes(
+            const int width, const int height, const int bytes_per_texel,
+            const bool mipmapped) noexcept
+        {
+            auto bytes = 0ull;
+            auto w = width;
+            auto h = height;
+
+            while (true)
+            {
+                bytes += static_cast<std::size_t>(w * h * bytes_per_texel);
+                if (!mipmapped || (w == 1 && h == 1))
+                {
+                    return bytes;
+                }
+
+                w = std::max(w / 2, 1);
+                h = std::max(h / 2, 1);
+            }
+        }
+
+    private:
+        struct Entry
+        {
+            std::size_t bytes;
+            unsigned long long last_bound;
+            bool resident;
+            bool reloading;
+            bool evictable;
+            std::function<void()> reload;
+        };
+
+        [[nodiscard]] static constexpr std::uint64_t key(
+            const Category category, const GLuint id) noexcept
+        {
+            return (static_cast<std::uint64_t>(category) << 32)
+                | static_cast<std::uint64_t>(id);
+        }
+
+        static inline void add(const Category category,
+            const Entry& entry) noexcept
+        {
+            if (entry.resident)
+            {
+                s_totals[static_cast<std::size_t>(category)] += entry.bytes;
+            }
+        }
+
+        static inline void subtract(const Category category,
+            const Entry& entry) noexcept
+        {
+            if (entry.resident)
+            {
+                s_totals[static_cast<std::size_t>(category)] -= entry.bytes;
+            }
+        }
+
+        static inline void enforce() noexcept
+        {
+            if (s_defer)
+            {
+                return;
+            }
+
+            while (Gpu_Memory::get_total() > s_budget)
+            {
+                auto victim = std::ranges::end(s_entries);
+                for (auto it = std::ranges::begin(s_entries);
+                    it != std::ranges::end(s_entries); ++it)
+                {
+                    if (it->second.evictable && it->second.resident
+                        && it->second.last_bound != s_tick
+                        && (victim == std::ranges::end(s_entries)
+                            || it->second.last_bound
+                                < victim->second.last_bound))
+                    {
+                        victim = it;
+                    }
+                }
+
+                if (victim == std::ranges::end(s_entries))
+                {
+                    return;
+                }
+
+                Gpu_Memory::evict(static_cast<GLuint>(victim->first),
+                    victim->second);
+            }
+        }
+
+        static inline void evict(const GLuint id, Entry& entry) noexcept
+        {
+            auto bound = GLint{ 0 };
+            glGetIntegerv(GL_TEXTURE_BINDING_2D, &bound);
+
+            // Redefining every level as 0x0 releases the storage but keeps
+            // the name alive, so the owning Texture never notices.
+            glBindTexture(GL_TEXTURE_2D, id);
+            for (auto level = 0; level < 32; ++level)
+            {
+                auto width = GLint{ 0 };
+                glGetTexLevelParameteriv(GL_TEXTURE_2D, level,
+                    GL_TEXTURE_WIDTH, &width);
+                if (width == 0)
+                {
+                    break;
+                }
+
+                glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, 0, 0, 0,
+                    GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            }
+            glBindTexture(GL_TEXTURE_2D, static_cast<GLuint>(bound));
+
+            Gpu_Memory::subtract(Category::Texture, entry);
+            entry.resident = false;
+            ++s_evictions;
+        }
+
+        static inline auto s_mutex = std::recursive_mutex{};
+        static inline auto s_entries =
+            std::unordered_map<std::uint64_t, Entry>{};
+        constinit static inline auto s_totals = std::array<std::size_t, 4>{};
+        constinit static inline auto s_budget =
+            std::numeric_limits<std::size_t>::max();
+        constinit static inline auto s_tick = 0ull;
+        constinit static inline auto s_evictions = 0ull;
+        constinit static inline auto s_reloads = 0ull;
+        constinit static inline thread_local auto s_defer = false;
+    };
+}
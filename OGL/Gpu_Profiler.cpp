@@ -0,0 +1,237 @@
+// Gpu_Profiler.cpp
+
+export module Eqx.OGL.Gpu_Profiler;
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glad/glad.hpp>;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    static_assert(std::same_as<GLuint, unsigned int>);
+
+    struct Gpu_Scope_Stats
+    {
+        unsigned long long count;
+        double total_ms;
+        double last_ms;
+        double max_ms;
+
+        [[nodiscard]] constexpr double average_ms() const noexcept
+        {
+            return this->count == 0ull
+                ? 0.0 : this->total_ms / static_cast<double>(this->count);
+        }
+    };
+
+    /*
+     * GPU time per named scope. Every scope is a pair of GL_TIMESTAMP
+     * queries, so scopes may nest, unlike GL_TIME_ELAPSED. Results are only
+     * read once they are at least c_latency frames old and the driver
+     * reports them available, the CPU never waits on the GPU. new_frame() is
+     * called by Window::swap. All functions must be called from the thread
+     * that owns the GL context.
+     */
+    class Gpu_Profiler
+    {
+    public:
+        static constexpr auto c_latency = 3ull;
+
+        Gpu_Profiler() = delete;
+        Gpu_Profiler(const Gpu_Profiler&) = delete;
+        Gpu_Profiler(Gpu_Profiler&&) = delete;
+        Gpu_Profiler& operator= (const Gpu_Profiler&) = delete;
+        Gpu_Profiler& operator= (Gpu_Profiler&&) = delete;
+        ~Gpu_Profiler() = delete;
+
+        [[nodiscard]] static inline std::size_t begin(
+            const std::string_view name) noexcept
+        {
+            if (!s_enabled)
+            {
+                return c_none;
+            }
+
+            auto& scope = s_pending.emplace_back(std::string{ name },
+                Gpu_Profiler::acquire(), Gpu_Profiler::acquire(), s_frame,
+                false);
+            glQueryCounter(scope.start, GL_TIMESTAMP);
+
+            return s_first + std::ranges::size(s_pending) - 1;
+        }
+
+        static inline void end(const std::size_t scope) noexcept
+        {
+            if (scope == c_none)
+            {
+                return;
+            }
+
+            assert(scope >= s_first);
+            auto& pending = s_pending[scope - s_first];
+            assert(!pending.ended);
+
+            glQueryCounter(pending.stop, GL_TIMESTAMP);
+            pending.ended = true;
+        }
+
+        static inline void new_frame() noexcept
+        {
+            ++s_frame;
+
+            while (!std::ranges::empty(s_pending))
+            {
+                auto& scope = s_pending.front();
+                if (!scope.ended || scope.frame + c_latency > s_frame)
+                {
+                    return;
+                }
+
+                auto available = GLint{ 0 };
+                glGetQueryObjectiv(scope.stop, GL_QUERY_RESULT_AVAILABLE,
+                    &available);
+                if (available == GL_FALSE)
+                {
+                    return;
+                }
+
+                auto start = GLuint64{ 0 };
+                auto stop = GLuint64{ 0 };
+                glGetQueryObjectui64v(scope.start, GL_QUERY_RESULT, &start);
+                glGetQueryObjectui64v(scope.stop, GL_QUERY_RESULT, &stop);
+                Gpu_Profiler::record(scope.name,
+                    static_cast<double>(stop - start) / 1'000'000.0);
+
+                s_free.push_back(scope.start);
+                s_free.push_back(scope.stop);
+                s_pending.pop_front();
+                ++s_first;
+            }
+        }
+
+        static inline void set_enabled(const bool enabled) noexcept
+        {
+            s_enabled = enabled;
+        }
+
+        [[nodiscard]] static inline std::optional<Gpu_Scope_Stats> get_stats(
+            const std::string_view name) noexcept
+        {
+            const auto it = s_stats.find(name);
+            return it == std::ranges::end(s_stats)
+                ? std::nullopt
+                : std::optional<Gpu_Scope_Stats>{ it->second };
+        }
+
+        [[nodiscard]] static inline const
+            std::map<std::string, Gpu_Scope_Stats, std::less<>>&
+            get_all() noexcept
+        {
+            return s_stats;
+        }
+
+        static inline void reset() noexcept
+        {
+            s_stats.clear();
+        }
+
+        /*
+         * Deletes every query object, the context must still be current.
+         */
+        static inline void free() noexcept
+        {
+            for (const auto& scope : s_pending)
+            {
+                s_free.push_back(scope.start);
+                s_free.push_back(scope.stop);
+            }
+            s_first += std::ranges::size(s_pending);
+            s_pending.clear();
+
+            if (!std::ranges::empty(s_free))
+            {
+                glDeleteQueries(
+                    static_cast<GLsizei>(std::ranges::size(s_free)),
+                    std::ranges::data(s_free));
+                s_free.clear();
+            }
+        }
+
+    private:
+        struct Pending
+        {
+            std::string name;
+            GLuint start;
+            GLuint stop;
+            unsigned long long frame;
+            bool ended;
+        };
+
+        static constexpr auto c_none = std::numeric_limits<std::size_t>::max();
+
+        [[nodiscard]] static inline GLuint acquire() noexcept
+        {
+            if (std::ranges::empty(s_free)) [[unlikely]]
+            {
+                auto ids = std::array<GLuint, 16>{};
+                glGenQueries(static_cast<GLsizei>(std::ranges::size(ids)),
+                    std::ranges::data(ids));
+                s_free.insert(std::ranges::end(s_free),
+                    std::ranges::begin(ids), std::ranges::end(ids));
+            }
+
+            const auto id = s_free.back();
+            s_free.pop_back();
+            return id;
+        }
+
+        static inline void record(const std::string_view name,
+            const double ms) noexcept
+        {
+            auto it = s_stats.find(name);
+            if (it == std::ranges::end(s_stats)) [[unlikely]]
+            {
+                it = s_stats.emplace(std::string{ name },
+                    Gpu_Scope_Stats{ 0ull, 0.0, 0.0, 0.0 }).first;
+            }
+
+            auto& stats = it->second;
+            ++stats.count;
+            stats.total_ms += ms;
+            stats.last_ms = ms;
+            stats.max_ms = std::max(stats.max_ms, ms);
+        }
+
+        static inline auto s_pending = std::deque<Pending>{};
+        static inline auto s_free = std::vector<GLuint>{};
+        static inline auto s_stats =
+            std::map<std::string, Gpu_Scope_Stats, std::less<>>{};
+        constinit static inline auto s_first = std::size_t{ 0 };
+        constinit static inline auto s_frame = 0ull;
+        constinit static inline auto s_enabled = true;
+    };
+
+    class Gpu_Scope
+    {
+    public:
+        Gpu_Scope(const Gpu_Scope&) = delete;
+        Gpu_Scope(Gpu_Scope&&) = delete;
+        Gpu_Scope& operator= (const Gpu_Scope&) = delete;
+        Gpu_Scope& operator= (Gpu_Scope&&) = delete;
+
+        explicit inline Gpu_Scope(const std::string_view name) noexcept
+            :
+            m_scope(Gpu_Profiler::begin(name))
+        {
+        }
+
+        inline ~Gpu_Scope() noexcept
+        {
+            Gpu_Profiler::end(this->m_scope);
+        }
+
+    private:
+        std::size_t m_scope;
+    };
+}
@@ -0,0 +1,287 @@
+// Input.cpp
+
+export module Eqx.OGL.Input;
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glfw/glfw.hpp>;
+import Eqx.Lib;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    struct Input_Event
+    {
+        enum class Type : std::uint8_t
+        {
+            Key,
+            Mouse_Button,
+            Cursor,
+            Scroll
+        };
+
+        Type type;
+        int code;
+        bool down;
+        eqx::lib::Point<float> value;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    /*
+     * Everything the window reported up to one snapshot. Cursor positions
+     * have y pointing up, scroll is the offset since the previous snapshot
+     * and events are in arrival order.
+     */
+    class Input_State
+    {
+    public:
+        Input_State(const Input_State&) = default;
+        Input_State(Input_State&&) = default;
+        Input_State& operator= (const Input_State&) = default;
+        Input_State& operator= (Input_State&&) = default;
+        ~Input_State() = default;
+
+        explicit inline Input_State() noexcept
+            :
+            m_keys(),
+            m_pressed(),
+            m_released(),
+            m_buttons(),
+            m_cursor(eqx::lib::Point<float>::origin()),
+            m_scroll(eqx::lib::Point<float>::origin()),
+            m_events(),
+            m_time()
+        {
+        }
+
+        [[nodiscard]] inline bool key_down(const int key) const noexcept
+        {
+            return Input_State::valid_key(key)
+                && this->m_keys.test(static_cast<std::size_t>(key));
+        }
+
+        /*
+         * True if the key went down since the previous snapshot, even when
+         * it was released again before this one.
+         */
+        [[nodiscard]] inline bool key_pressed(const int key) const noexcept
+        {
+            return Input_State::valid_key(key)
+                && this->m_pressed.test(static_cast<std::size_t>(key));
+        }
+
+        [[nodiscard]] inline bool key_released(const int key) const noexcept
+        {
+            return Input_State::valid_key(key)
+                && this->m_released.test(static_cast<std::size_t>(key));
+        }
+
+        [[nodiscard]] inline bool mouse_button_down(
+            const int button) const noexcept
+        {
+            return button >= 0 && button <= GLFW_MOUSE_BUTTON_LAST
+                && this->m_buttons.test(static_cast<std::size_t>(button));
+        }
+
+        [[nodiscard]] constexpr const eqx::lib::Point<float>&
+            get_cursor() const noexcept
+        {
+            return this->m_cursor;
+        }
+
+        [[nodiscard]] constexpr const eqx::lib::Point<float>&
+            get_scroll() const noexcept
+        {
+            return this->m_scroll;
+        }
+
+        [[nodiscard]] inline std::span<const Input_Event>
+            get_events() const noexcept
+        {
+            return this->m_events;
+        }
+
+        [[nodiscard]] constexpr std::chrono::steady_clock::time_point
+            get_time() const noexcept
+        {
+            return this->m_time;
+        }
+
+        /*
+         * Time between the oldest buffered event and the snapshot, zero when
+         * nothing happened.
+         */
+        [[nodiscard]] inline std::chrono::steady_clock::duration
+            get_latency() const noexcept
+        {
+            return std::ranges::empty(this->m_events)
+                ? std::chrono::steady_clock::duration::zero()
+                : this->m_time - this->m_events.front().time;
+        }
+
+    private:
+        friend class Input;
+
+        [[nodiscard]] static constexpr bool valid_key(const int key) noexcept
+        {
+            return key >= 0 && key <= GLFW_KEY_LAST;
+        }
+
+        std::bitset<GLFW_KEY_LAST + 1> m_keys;
+        std::bitset<GLFW_KEY_LAST + 1> m_pressed;
+        std::bitset<GLFW_KEY_LAST + 1> m_released;
+        std::bitset<GLFW_MOUSE_BUTTON_LAST + 1> m_buttons;
+        eqx::lib::Point<float> m_cursor;
+        eqx::lib::Point<float> m_scroll;
+        std::vector<Input_Event> m_events;
+        std::chrono::steady_clock::time_point m_time;
+    };
+
+    /*
+     * GLFW callbacks write into a live state while events are polled,
+     * snapshot() publishes it so a frame reads input with no GLFW calls. The
+     * address is handed to GLFW, so an Input must not move once attached.
+     */
+    class Input
+    {
+    public:
+        Input(const Input&) = delete;
+        Input(Input&&) = delete;
+        Input& operator= (const Input&) = delete;
+        Input& operator= (Input&&) = delete;
+        ~Input() = default;
+
+        explicit inline Input() noexcept
+            :
+            m_live(),
+            m_snapshot()
+        {
+        }
+
+        inline void attach(GLFWwindow* const window) noexcept
+        {
+            assert(window != nullptr);
+
+            glfwSetWindowUserPointer(window, this);
+            glfwSetKeyCallback(window, Input::on_key);
+            glfwSetMouseButtonCallback(window, Input::on_mouse_button);
+            glfwSetCursorPosCallback(window, Input::on_cursor);
+            glfwSetScrollCallback(window, Input::on_scroll);
+
+            auto x = 0.0;
+            auto y = 0.0;
+            glfwGetCursorPos(window, &x, &y);
+            this->m_live.m_cursor = eqx::lib::Point<float>{
+                static_cast<float>(x), static_cast<float>(-y) };
+            this->snapshot();
+        }
+
+        inline void snapshot() noexcept
+        {
+            this->m_live.m_time = std::chrono::steady_clock::now();
+
+            this->m_snapshot.m_keys = this->m_live.m_keys;
+            this->m_snapshot.m_pressed = std::exchange(this->m_live.m_pressed,
+                std::bitset<GLFW_KEY_LAST + 1>{});
+            this->m_snapshot.m_released = std::exchange(
+                this->m_live.m_released, std::bitset<GLFW_KEY_LAST + 1>{});
+            this->m_snapshot.m_buttons = this->m_live.m_buttons;
+            this->m_snapshot.m_cursor = this->m_live.m_cursor;
+            this->m_snapshot.m_scroll = std::exchange(this->m_live.m_scroll,
+                eqx::lib::Point<float>::origin());
+            this->m_snapshot.m_time = this->m_live.m_time;
+
+            // Swapping keeps both vectors' capacity, so steady state input
+            // does not allocate.
+            std::swap(this->m_snapshot.m_events, this->m_live.m_events);
+            this->m_live.m_events.clear();
+        }
+
+        [[nodiscard]] constexpr const Input_State& get_snapshot()
+            const noexcept
+        {
+            return this->m_snapshot;
+        }
+
+    private:
+        [[nodiscard]] static inline Input& from(
+            GLFWwindow* const window) noexcept
+        {
+            auto* const input =
+                static_cast<Input*>(glfwGetWindowUserPointer(window));
+            assert(input != nullptr);
+
+            return *input;
+        }
+
+        static inline void on_key(GLFWwindow* window, int key,
+            [[maybe_unused]] int scancode, int action,
+            [[maybe_unused]] int mods) noexcept
+        {
+            if (!Input_State::valid_key(key) || action == GLFW_REPEAT)
+            {
+                return;
+            }
+
+            auto& live = Input::from(window).m_live;
+            const auto i = static_cast<std::size_t>(key);
+            const auto down = action == GLFW_PRESS;
+            live.m_keys.set(i, down);
+            if (down)
+            {
+                live.m_pressed.set(i);
+            }
+            else
+            {
+                live.m_released.set(i);
+            }
+
+            live.m_events.emplace_back(Input_Event::Type::Key, key, down,
+                eqx::lib::Point<float>::origin(),
+                std::chrono::steady_clock::now());
+        }
+
+        static inline void on_mouse_button(GLFWwindow* window, int button,
+            int action, [[maybe_unused]] int mods) noexcept
+        {
+            if (button < 0 || button > GLFW_MOUSE_BUTTON_LAST)
+            {
+                return;
+            }
+
+            auto& live = Input::from(window).m_live;
+            const auto down = action == GLFW_PRESS;
+            live.m_buttons.set(static_cast<std::size_t>(button), down);
+
+            live.m_events.emplace_back(Input_Event::Type::Mouse_Button,
+                button, down, live.m_cursor,
+                std::chrono::steady_clock::now());
+        }
+
+        static inline void on_cursor(GLFWwindow* window, double x,
+            double y) noexcept
+        {
+            auto& live = Input::from(window).m_live;
+            live.m_cursor = eqx::lib::Point<float>{ static_cast<float>(x),
+                static_cast<float>(-y) };
+
+            live.m_events.emplace_back(Input_Event::Type::Cursor, 0, false,
+                live.m_cursor, std::chrono::steady_clock::now());
+        }
+
+        static inline void on_scroll(GLFWwindow* window, double x,
+            double y) noexcept
+        {
+            auto& live = Input::from(window).m_live;
+            const auto offset = eqx::lib::Point<float>{
+                static_cast<float>(x), static_cast<float>(y) };
+            live.m_scroll.translate(offset);
+
+            live.m_events.emplace_back(Input_Event::Type::Scroll, 0, false,
+                offset, std::chrono::steady_clock::now());
+        }
+
+        Input_State m_live;
+        Input_State m_snapshot;
+    };
+}
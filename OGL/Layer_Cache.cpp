@@ -0,0 +1,232 @@
+// Layer_Cache.cpp
+
+export module Eqx.OGL.Layer_Cache;
+
+import Eqx.OGL.Framebuffer;
+import Eqx.OGL.Spatial_Grid;
+import Eqx.OGL.Sprite_Batch;
+import Eqx.OGL.Texture;
+import Eqx.OGL.Trace;
+import Eqx.OGL.Window;
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glad/glad.hpp>;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    /*
+     * Static layer rendered once into an offscreen texture.
+     *
+     * The texture covers the view plus margin on every side at the window's
+     * pixel density. update() redraws it only after invalidate(), a zoom,
+     * a window resize or a pan leaving the covered region, any other pan
+     * just moves get_uv() so the layer costs a single quad per frame. The
+     * region is snapped to whole texels so redraws at one zoom line up
+     * with each other.
+     */
+    class Layer_Cache
+    {
+    public:
+        Layer_Cache(const Layer_Cache&) = delete;
+        Layer_Cache& operator= (const Layer_Cache&) = delete;
+        Layer_Cache(Layer_Cache&&) = default;
+        Layer_Cache& operator= (Layer_Cache&&) = default;
+        ~Layer_Cache() = default;
+
+        explicit inline Layer_Cache(const Window& window,
+            const float margin = 0.25F) noexcept
+            :
+            m_window(&window),
+            m_margin(margin),
+            m_size(0, 0),
+            m_texture(),
+            m_framebuffer(),
+            m_region(),
+            m_view_width(0.0F),
+            m_view_height(0.0F),
+            m_dirty(true),
+            m_renders(0ull)
+        {
+            assert(margin >= 0.0F);
+        }
+
+        /*
+         * draw is called with the region to cover while the cache's
+         * framebuffer is bound with a matching viewport and cleared to
+         * transparent, the window's framebuffer is bound again afterwards.
+         * Returns whether the layer was redrawn.
+         */
+        template <typename Draw>
+            requires std::invocable<Draw&, const Aabb&>
+        inline bool update(const Aabb& view, Draw&& draw) noexcept
+        {
+            const auto width = view.right - view.left;
+            const auto height = view.top - view.bottom;
+            assert(width > 0.0F && height > 0.0F);
+
+            // Nothing is presented while minimized.
+            const auto size = this->m_window->get_framebuffer_size();
+            if (size.first == 0 || size.second == 0)
+            {
+                return false;
+            }
+
+            if (size != this->m_size)
+            {
+                this->resize(size);
+            }
+
+            if (!this->m_dirty
+                && Layer_Cache::same(width, this->m_view_width)
+                && Layer_Cache::same(height, this->m_view_height)
+                && this->covers(view))
+            {
+                return false;
+            }
+
+            const auto zone = Zone{ "Layer_Cache::update"sv };
+            this->m_view_width = width;
+            this->m_view_height = height;
+            this->m_region = this->place(view);
+
+            auto clear = std::array<GLfloat, 4>{};
+            glGetFloatv(GL_COLOR_CLEAR_VALUE, clear.data());
+            this->m_framebuffer.enable();
+            glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
+            glClearColor(clear[0], clear[1], clear[2], clear[3]);
+
+            std::invoke(draw, std::as_const(this->m_region));
+
+            this->m_framebuffer.disable(*this->m_window);
+
+            this->m_dirty = false;
+            ++this->m_renders;
+            return true;
+        }
+
+        constexpr void invalidate() noexcept
+        {
+            this->m_dirty = true;
+        }
+
+        /*
+         * Texture coordinates of view within the cached region, for drawing
+         * get_texture() over the view's corners. Rows are stored bottom up
+         * so v0 is the view's top edge.
+         */
+        [[nodiscard]] constexpr Uv_Rect get_uv(const Aabb& view) const noexcept
+        {
+            const auto width = this->m_region.right - this->m_region.left;
+            const auto height = this->m_region.top - this->m_region.bottom;
+
+            return Uv_Rect{
+                (view.left - this->m_region.left) / width,
+                (view.top - this->m_region.bottom) / height,
+                (view.right - this->m_region.left) / width,
+                (view.bottom - this->m_region.bottom) / height };
+        }
+
+        [[nodiscard]] constexpr const Texture& get_texture() const noexcept
+        {
+            return this->m_texture;
+        }
+
+        [[nodiscard]] constexpr const Aabb& get_region() const noexcept
+        {
+            return this->m_region;
+        }
+
+        // Texels across the region, what draw renders at horizontally.
+        [[nodiscard]] inline int get_texture_width() const noexcept
+        {
+            return this->texture_width();
+        }
+
+        // Redraws since construction.
+        [[nodiscard]] constexpr unsigned long long
+            get_renders() const noexcept
+        {
+            return this->m_renders;
+        }
+
+    private:
+        [[nodiscard]] static constexpr bool same(const float a,
+            const float b) noexcept
+        {
+            return std::abs(a - b) <= b * 1e-4F;
+        }
+
+        [[nodiscard]] constexpr bool covers(const Aabb& view) const noexcept
+        {
+            return view.left >= this->m_region.left
+                && view.right <= this->m_region.right
+                && view.bottom >= this->m_region.bottom
+                && view.top <= this->m_region.top;
+        }
+
+        [[nodiscard]] inline Aabb place(const Aabb& view) const noexcept
+        {
+            const auto texel_x = (view.right - view.left)
+                / static_cast<float>(this->m_size.first);
+            const auto texel_y = (view.top - view.bottom)
+                / static_cast<float>(this->m_size.second);
+            const auto left = std::floor((view.left
+                - (view.right - view.left) * this->m_margin) / texel_x)
+                * texel_x;
+            const auto bottom = std::floor((view.bottom
+                - (view.top - view.bottom) * this->m_margin) / texel_y)
+                * texel_y;
+
+            return Aabb{ left, bottom,
+                left + static_cast<float>(this->texture_width()) * texel_x,
+                bottom + static_cast<float>(this->texture_height()) * texel_y };
+        }
+
+        inline void resize(const std::pair<int, int>& size) noexcept
+        {
+            this->m_size = size;
+            if (this->m_framebuffer.valid())
+            {
+                this->m_framebuffer.free();
+                this->m_texture.free();
+            }
+
+            this->m_texture.init(this->texture_width(),
+                this->texture_height());
+            this->m_framebuffer.init();
+            this->m_framebuffer.attach_color(this->m_texture,
+                this->texture_width(), this->texture_height());
+            assert(this->m_framebuffer.complete());
+            this->m_framebuffer.disable(*this->m_window);
+
+            this->m_dirty = true;
+        }
+
+        // One extra texel absorbs the snapping of the region's corner.
+        [[nodiscard]] inline int texture_width() const noexcept
+        {
+            return static_cast<int>(std::ceil(static_cast<float>(
+                this->m_size.first) * (1.0F + 2.0F * this->m_margin))) + 1;
+        }
+
+        [[nodiscard]] inline int texture_height() const noexcept
+        {
+            return static_cast<int>(std::ceil(static_cast<float>(
+                this->m_size.second) * (1.0F + 2.0F * this->m_margin))) + 1;
+        }
+
+        const Window* m_window;
+        float m_margin;
+        std::pair<int, int> m_size;
+        Texture m_texture;
+        Framebuffer m_framebuffer;
+        Aabb m_region;
+        float m_view_width;
+        float m_view_height;
+        bool m_dirty;
+        unsigned long long m_renders;
+    };
+}
@@ -0,0 +1,184 @@
+// Loop.cpp
+
+export module Eqx.OGL.Loop;
+
+import <Eqx/std.hpp>;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    /*
+     * Fixed timestep driver.
+     *
+     * advance() turns elapsed wall time into a whole number of simulation
+     * ticks and keeps the remainder, get_alpha() is that remainder as a
+     * fraction of a tick for interpolating between the last two simulation
+     * states. Catch up is capped at max_steps ticks per frame, time beyond
+     * that is dropped instead of spiralling. With a render rate set, frames
+     * are only rendered at that rate and wait() sleeps until either the next
+     * tick or the next frame is due.
+     */
+    class Loop
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        Loop(const Loop&) = default;
+        Loop(Loop&&) = default;
+        Loop& operator= (const Loop&) = default;
+        Loop& operator= (Loop&&) = default;
+        ~Loop() = default;
+
+        explicit inline Loop(const float tick = 1.0F / 60.0F,
+            const int max_steps = 8) noexcept
+            :
+            m_tick(std::chrono::duration<double>{ tick }),
+            m_max_steps(max_steps),
+            m_render_interval(Clock::duration::zero()),
+            m_accumulator(std::chrono::duration<double>::zero()),
+            m_dropped(std::chrono::duration<double>::zero()),
+            m_last(Clock::now()),
+            m_last_render(m_last),
+            m_steps(0ull)
+        {
+            assert(tick > 0.0F);
+            assert(max_steps > 0);
+        }
+
+        [[nodiscard]] inline int advance() noexcept
+        {
+            const auto now = Clock::now();
+            this->m_accumulator += now - this->m_last;
+            this->m_last = now;
+
+            const auto max = this->m_tick * this->m_max_steps;
+            if (this->m_accumulator > max) [[unlikely]]
+            {
+                this->m_dropped += this->m_accumulator - max;
+                this->m_accumulator = max;
+            }
+
+            const auto steps =
+                static_cast<int>(this->m_accumulator / this->m_tick);
+            this->m_accumulator -= this->m_tick * steps;
+            this->m_steps += static_cast<unsigned long long>(steps);
+
+            return steps;
+        }
+
+        [[nodiscard]] inline bool should_render() noexcept
+        {
+            if (this->m_render_interval == Clock::duration::zero())
+            {
+                return true;
+            }
+
+            const auto now = Clock::now();
+            if (now - this->m_last_render < this->m_render_interval)
+            {
+                return false;
+            }
+
+            this->m_last_render += this->m_render_interval;
+            if (now - this->m_last_render >= this->m_render_interval)
+            {
+                this->m_last_render = now;
+            }
+
+            return true;
+        }
+
+        inline void wait() const noexcept
+        {
+            if (this->m_render_interval == Clock::duration::zero())
+            {
+                return;
+            }
+
+            const auto next_tick = this->m_last
+                + std::chrono::duration_cast<Clock::duration>(
+                    this->m_tick - this->m_accumulator);
+            const auto next_render =
+                this->m_last_render + this->m_render_interval;
+
+            std::this_thread::sleep_until(std::min(next_tick, next_render));
+        }
+
+        /*
+         * Drops the time since the last advance() instead of catching up on
+         * it, for callers that blocked while the simulation had settled and
+         * its ticks would have changed nothing.
+         */
+        inline void resume() noexcept
+        {
+            this->m_last = Clock::now();
+        }
+
+        /*
+         * Convenience driver for loops that need nothing between the steps:
+         * update(tick) runs once per tick, render(alpha) once per frame.
+         */
+        template <typename T_Running, typename T_Update, typename T_Render>
+        inline void run(T_Running&& running, T_Update&& update,
+            T_Render&& render) noexcept
+        {
+            while (running())
+            {
+                const auto steps = this->advance();
+                for (auto i = 0; i < steps; ++i)
+                {
+                    update(this->get_tick());
+                }
+
+                if (this->should_render())
+                {
+                    render(this->get_alpha());
+                }
+
+                this->wait();
+            }
+        }
+
+        inline void set_render_rate(const float hz) noexcept
+        {
+            assert(hz >= 0.0F);
+
+            this->m_render_interval = hz == 0.0F
+                ? Clock::duration::zero()
+                : std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>{ 1.0 / hz });
+            this->m_last_render = Clock::now();
+        }
+
+        [[nodiscard]] inline float get_tick() const noexcept
+        {
+            return static_cast<float>(this->m_tick.count());
+        }
+
+        [[nodiscard]] inline float get_alpha() const noexcept
+        {
+            return static_cast<float>(this->m_accumulator / this->m_tick);
+        }
+
+        [[nodiscard]] constexpr unsigned long long get_steps() const noexcept
+        {
+            return this->m_steps;
+        }
+
+        [[nodiscard]] inline float get_dropped() const noexcept
+        {
+            return static_cast<float>(this->m_dropped.count());
+        }
+
+    private:
+        std::chrono::duration<double> m_tick;
+        int m_max_steps;
+        Clock::duration m_render_interval;
+        std::chrono::duration<double> m_accumulator;
+        std::chrono::duration<double> m_dropped;
+        Clock::time_point m_last;
+        Clock::time_point m_last_render;
+        unsigned long long m_steps;
+    };
+}
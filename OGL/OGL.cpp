@@ -2,8 +2,30 @@ export module Eqx.OGL;
 
 export import Eqx.OGL.Buffer;
 //export import Eqx.OGL.Context;
+export import Eqx.OGL.Frame_Limiter;
+export import Eqx.OGL.Framebuffer;
+export import Eqx.OGL.Gpu_Memory;
+export import Eqx.OGL.Gpu_Profiler;
+export import Eqx.OGL.Input;
+export import Eqx.OGL.Layer_Cache;
+export import Eqx.OGL.Loop;
+export import Eqx.OGL.Pack;
+export import Eqx.OGL.Particle_System;
+export import Eqx.OGL.Render_Queue;
+export import Eqx.OGL.Render_Thread;
+export import Eqx.OGL.Replay;
+export import Eqx.OGL.Sampler;
 export import Eqx.OGL.Shader_Program;
 export import Eqx.OGL.Shader_Source;
+export import Eqx.OGL.Spatial_Grid;
+export import Eqx.OGL.Sprite_Batch;
+export import Eqx.OGL.Sprite_Builder;
+export import Eqx.OGL.Sprite_Instancer;
+export import Eqx.OGL.Texel_Pipeline;
 export import Eqx.OGL.Texture;
+export import Eqx.OGL.Tile_Map;
+export import Eqx.OGL.Tiled_Texture;
+export import Eqx.OGL.Trace;
+export import Eqx.OGL.Upload_Worker;
 export import Eqx.OGL.Vertex_Array;
 export import Eqx.OGL.Window;
@@ -0,0 +1,684 @@
+// Pack.cpp
+
+module;
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif // _WIN32
+
+export module Eqx.OGL.Pack;
+
+import Eqx.OGL.Texel_Pipeline;
+import Eqx.OGL.Texture;
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/stb/stb_image.hpp>;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    /*
+     * Pack layout, all integers little endian:
+     *
+     *     Pack_Header
+     *     Pack_Entry[entry_count]    at toc_offset
+     *     blobs                      each at a c_pack_alignment boundary
+     *
+     * Texture blobs hold decoded texels (width * height * channels bytes),
+     * RGB images are expanded to RGBA when packed. Shader and raw blobs hold
+     * the file bytes verbatim.
+     *
+     * A tiled texture is a Tiled entry, its width and height those of the
+     * full image and its blob a Pack_Tiles, followed by one RGBA Texture
+     * entry per tile. Tiles are cut from every level of the image's mip
+     * chain, halving until a level fits in one tile, and stored finest level
+     * first and row by row from the top within a level, so tile (x, y) of a
+     * level is entry first + level offset + y * tiles across + x.
+     */
+    enum class Pack_Kind : std::uint32_t
+    {
+        Raw = 0u,
+        Texture = 1u,
+        Shader = 2u,
+        Tiled = 3u
+    };
+
+    struct Pack_Header
+    {
+        std::array<char, 8> magic;
+        std::uint32_t version;
+        std::uint32_t entry_count;
+        std::uint64_t toc_offset;
+    };
+
+    struct Pack_Entry
+    {
+        std::array<char, 64> name;
+        Pack_Kind kind;
+        std::uint32_t width;
+        std::uint32_t height;
+        std::uint32_t channels;
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    struct Pack_Tiles
+    {
+        std::uint32_t tile_size;
+        std::uint32_t level_count;
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+    static_assert(sizeof(Pack_Header) == 24);
+    static_assert(sizeof(Pack_Entry) == 96);
+    static_assert(sizeof(Pack_Tiles) == 16);
+    static_assert(std::is_trivially_copyable_v<Pack_Header>);
+    static_assert(std::is_trivially_copyable_v<Pack_Entry>);
+    static_assert(std::is_trivially_copyable_v<Pack_Tiles>);
+
+    constexpr auto c_pack_magic =
+        std::array<char, 8>{ 'E', 'Q', 'X', 'P', 'A', 'C', 'K', '\0' };
+    constexpr auto c_pack_version = std::uint32_t{ 2 };
+    constexpr auto c_pack_alignment = std::uint64_t{ 64 };
+
+    /*
+     * Read only mapping of a pack file.
+     *
+     * init() checks the header, the table of contents and every entry's
+     * bounds before the pack becomes valid(), texture entries must also
+     * hold exactly width * height * channels bytes. A missing, truncated or
+     * otherwise corrupt file leaves the Pack invalid rather than exposing
+     * memory past the mapping.
+     */
+    class Pack
+    {
+    public:
+        Pack(const Pack&) = delete;
+        Pack& operator= (const Pack&) = delete;
+
+        explicit constexpr Pack() noexcept
+            :
+            m_data(nullptr),
+            m_size(0ull)
+        {
+        }
+
+        explicit inline Pack(const std::filesystem::path& path) noexcept
+            :
+            m_data(nullptr),
+            m_size(0ull)
+        {
+            this->init(path);
+        }
+
+        constexpr Pack(Pack&& other) noexcept
+            :
+            m_data(std::exchange(other.m_data, nullptr)),
+            m_size(std::exchange(other.m_size, 0ull))
+        {
+        }
+
+        constexpr Pack& operator= (Pack&& other) noexcept
+        {
+            std::swap(this->m_data, other.m_data);
+            std::swap(this->m_size, other.m_size);
+            return *this;
+        }
+
+        inline ~Pack() noexcept
+        {
+            if (this->valid()) [[likely]]
+            {
+                this->free();
+            }
+        }
+
+        // Leaves the Pack invalid if path is not a well formed pack.
+        inline void init(const std::filesystem::path& path) noexcept
+        {
+            assert(!this->valid());
+
+            auto error = std::error_code{};
+            const auto size = std::filesystem::file_size(path, error);
+            if (error || size < sizeof(Pack_Header))
+            {
+                return;
+            }
+            this->m_size = static_cast<std::size_t>(size);
+
+#ifdef _WIN32
+            const auto file = CreateFileW(path.c_str(), GENERIC_READ,
+                FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file != INVALID_HANDLE_VALUE)
+            {
+                const auto mapping = CreateFileMappingW(file, nullptr,
+                    PAGE_READONLY, 0, 0, nullptr);
+                if (mapping != nullptr)
+                {
+                    this->m_data = static_cast<const std::byte*>(
+                        MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                    CloseHandle(mapping);
+                }
+                CloseHandle(file);
+            }
+#else
+            const auto fd = open(path.c_str(), O_RDONLY);
+            if (fd != -1)
+            {
+                const auto data = mmap(nullptr, this->m_size, PROT_READ,
+                    MAP_PRIVATE, fd, 0);
+                if (data != MAP_FAILED)
+                {
+                    this->m_data = static_cast<const std::byte*>(data);
+                }
+                close(fd);
+            }
+#endif // _WIN32
+
+            if (!this->valid())
+            {
+                this->m_size = 0ull;
+                return;
+            }
+
+            if (!this->check())
+            {
+                this->free();
+            }
+        }
+
+        [[nodiscard]] inline const Pack_Header& get_header() const noexcept
+        {
+            assert(this->valid());
+
+            return *reinterpret_cast<const Pack_Header*>(this->m_data);
+        }
+
+        [[nodiscard]] inline std::span<const Pack_Entry>
+            get_entries() const noexcept
+        {
+            assert(this->valid());
+
+            return std::span<const Pack_Entry>{
+                reinterpret_cast<const Pack_Entry*>(
+                    this->m_data + this->get_header().toc_offset),
+                this->get_header().entry_count };
+        }
+
+        [[nodiscard]] inline const Pack_Entry* find(
+            const std::string_view name) const noexcept
+        {
+            const auto entries = this->get_entries();
+            const auto it = std::ranges::find_if(entries,
+                [name](const Pack_Entry& entry) noexcept
+                {
+                    return Pack::get_name(entry) == name;
+                });
+
+            return it == std::ranges::end(entries) ? nullptr : &*it;
+        }
+
+        [[nodiscard]] inline std::span<const std::byte> get_data(
+            const Pack_Entry& entry) const noexcept
+        {
+            assert(this->valid());
+            assert(entry.offset + entry.size <= this->m_size);
+
+            return std::span<const std::byte>{ this->m_data + entry.offset,
+                entry.size };
+        }
+
+        // Names are not required to be NUL terminated when they fill the
+        // whole field.
+        [[nodiscard]] static inline std::string_view get_name(
+            const Pack_Entry& entry) noexcept
+        {
+            return std::string_view{ entry.name.data(),
+                strnlen(entry.name.data(), std::ranges::size(entry.name)) };
+        }
+
+        [[nodiscard]] inline std::optional<Texel_View> get_texture(
+            const std::string_view name) const noexcept
+        {
+            const auto entry = this->find(name);
+            if (entry == nullptr || entry->kind != Pack_Kind::Texture)
+            {
+                return std::nullopt;
+            }
+
+            const auto data = this->get_data(*entry);
+            return Texel_View{
+                std::span<const unsigned char>{
+                    reinterpret_cast<const unsigned char*>(data.data()),
+                    std::ranges::size(data) },
+                static_cast<int>(entry->width),
+                static_cast<int>(entry->height),
+                static_cast<int>(entry->channels) };
+        }
+
+        /*
+         * The tile layout of a tiled texture, its tile entries are known to
+         * be in the table of contents but are checked by the reader.
+         */
+        [[nodiscard]] inline std::optional<Pack_Tiles> get_tiles(
+            const std::string_view name) const noexcept
+        {
+            const auto entry = this->find(name);
+            if (entry == nullptr || entry->kind != Pack_Kind::Tiled)
+            {
+                return std::nullopt;
+            }
+
+            auto tiles = Pack_Tiles{};
+            std::memcpy(&tiles, this->get_data(*entry).data(), sizeof(tiles));
+            return tiles;
+        }
+
+        [[nodiscard]] inline std::optional<std::string_view> get_shader(
+            const std::string_view name) const noexcept
+        {
+            const auto entry = this->find(name);
+            if (entry == nullptr || entry->kind != Pack_Kind::Shader)
+            {
+                return std::nullopt;
+            }
+
+            const auto data = this->get_data(*entry);
+            return std::string_view{
+                reinterpret_cast<const char*>(data.data()),
+                std::ranges::size(data) };
+        }
+
+        [[nodiscard]] constexpr std::size_t get_size() const noexcept
+        {
+            return this->m_size;
+        }
+
+        [[nodiscard]] constexpr bool valid() const noexcept
+        {
+            return this->m_data != nullptr;
+        }
+
+        inline void free() noexcept
+        {
+            assert(this->valid());
+
+#ifdef _WIN32
+            UnmapViewOfFile(this->m_data);
+#else
+            munmap(const_cast<std::byte*>(this->m_data), this->m_size);
+#endif // _WIN32
+            this->m_data = nullptr;
+            this->m_size = 0ull;
+
+            assert(!this->valid());
+        }
+
+    private:
+        // Sizes are compared by division first so no product can overflow.
+        [[nodiscard]] inline bool check() const noexcept
+        {
+            const auto& header = this->get_header();
+            if (header.magic != c_pack_magic
+                || header.version != c_pack_version
+                || header.toc_offset > this->m_size
+                || header.toc_offset % alignof(Pack_Entry) != 0ull
+                || header.entry_count
+                    > (this->m_size - header.toc_offset) / sizeof(Pack_Entry))
+            {
+                return false;
+            }
+
+            return std::ranges::all_of(this->get_entries(),
+                [this](const Pack_Entry& entry) noexcept
+                {
+                    if (entry.offset > this->m_size
+                        || entry.size > this->m_size - entry.offset)
+                    {
+                        return false;
+                    }
+
+                    if (entry.kind == Pack_Kind::Tiled)
+                    {
+                        auto tiles = Pack_Tiles{};
+                        if (entry.size != sizeof(tiles))
+                        {
+                            return false;
+                        }
+
+                        std::memcpy(&tiles, this->m_data + entry.offset,
+                            sizeof(tiles));
+                        return tiles.tile_size > 0u && tiles.level_count > 0u
+                            && tiles.first <= this->get_header().entry_count
+                            && tiles.count <= this->get_header().entry_count
+                                - tiles.first;
+                    }
+
+                    if (entry.kind != Pack_Kind::Texture)
+                    {
+                        return true;
+                    }
+
+                    constexpr auto max = static_cast<std::uint32_t>(
+                        std::numeric_limits<int>::max());
+                    return entry.channels >= 1u && entry.channels <= 4u
+                        && entry.width > 0u && entry.width <= max
+                        && entry.height > 0u && entry.height <= max
+                        && entry.width
+                            <= entry.size / entry.height / entry.channels
+                        && std::uint64_t{ entry.width } * entry.height
+                            * entry.channels == entry.size;
+                });
+        }
+
+        const std::byte* m_data;
+        std::size_t m_size;
+    };
+
+    class Pack_Writer
+    {
+    public:
+        Pack_Writer(const Pack_Writer&) = default;
+        Pack_Writer(Pack_Writer&&) = default;
+        Pack_Writer& operator= (const Pack_Writer&) = default;
+        Pack_Writer& operator= (Pack_Writer&&) = default;
+        ~Pack_Writer() = default;
+
+        explicit inline Pack_Writer() noexcept
+            :
+            m_entries(),
+            m_blobs()
+        {
+        }
+
+        inline void add_texture(const std::string_view name,
+            const std::filesystem::path& path) noexcept
+        {
+            auto w = 0;
+            auto h = 0;
+            auto ch = 0;
+
+            unsigned char* data = stbi_load(path.string().c_str(),
+                &w, &h, &ch, 0);
+            assert(data != nullptr);
+
+            const auto size = static_cast<std::size_t>(w * h * ch);
+            auto blob = std::vector<std::byte>{};
+            if (ch == 3)
+            {
+                blob.resize(static_cast<std::size_t>(w * h * 4));
+                Texel_Pipeline::expand_rgb(
+                    std::span<const unsigned char>{ data, size },
+                    std::span<unsigned char>{
+                        reinterpret_cast<unsigned char*>(blob.data()),
+                        std::ranges::size(blob) });
+                ch = 4;
+            }
+            else
+            {
+                blob.assign(reinterpret_cast<const std::byte*>(data),
+                    reinterpret_cast<const std::byte*>(data) + size);
+            }
+
+            this->add(name, Pack_Kind::Texture, static_cast<std::uint32_t>(w),
+                static_cast<std::uint32_t>(h), static_cast<std::uint32_t>(ch),
+                std::move(blob));
+
+            stbi_image_free(data);
+        }
+
+        /*
+         * Packs the image as tiles of tile_size texels from every level of
+         * its mip chain, see Pack_Tiles. Each level averages 2x2 texels of
+         * the one above, clamped at odd edges.
+         */
+        inline void add_tiled_texture(const std::string_view name,
+            const std::filesystem::path& path,
+            const std::uint32_t tile_size) noexcept
+        {
+            assert(tile_size > 0u);
+
+            auto w = 0;
+            auto h = 0;
+            auto ch = 0;
+
+            unsigned char* data = stbi_load(path.string().c_str(),
+                &w, &h, &ch, 4);
+            assert(data != nullptr);
+
+            auto levels = std::vector<Level>{};
+            levels.emplace_back(w, h, std::vector<unsigned char>(data,
+                data + static_cast<std::size_t>(w * h * 4)));
+            stbi_image_free(data);
+
+            const auto size = static_cast<int>(tile_size);
+            while (levels.back().width > size || levels.back().height > size)
+            {
+                levels.push_back(Pack_Writer::reduce(levels.back()));
+            }
+
+            auto count = std::uint32_t{ 0 };
+            for (const auto& level : levels)
+            {
+                count += static_cast<std::uint32_t>(
+                    Pack_Writer::tiles(level.width, size)
+                    * Pack_Writer::tiles(level.height, size));
+            }
+
+            const auto tiles = Pack_Tiles{ tile_size,
+                static_cast<std::uint32_t>(std::ranges::size(levels)),
+                static_cast<std::uint32_t>(
+                    std::ranges::size(this->m_entries) + 1),
+                count };
+            auto blob = std::vector<std::byte>(sizeof(tiles));
+            std::memcpy(blob.data(), &tiles, sizeof(tiles));
+            this->add(name, Pack_Kind::Tiled, static_cast<std::uint32_t>(w),
+                static_cast<std::uint32_t>(h), 4u, std::move(blob));
+
+            for (auto l = std::size_t{ 0 }; l < std::ranges::size(levels); ++l)
+            {
+                const auto& level = levels[l];
+                for (auto y = 0; y < Pack_Writer::tiles(level.height, size);
+                    ++y)
+                {
+                    for (auto x = 0; x < Pack_Writer::tiles(level.width, size);
+                        ++x)
+                    {
+                        this->add_tile(std::format("{}#{}/{}/{}"sv,
+                            name, l, x, y), level, x * size, y * size, size);
+                    }
+                }
+            }
+        }
+
+        inline void add_shader(const std::string_view name,
+            const std::filesystem::path& path) noexcept
+        {
+            this->add(name, Pack_Kind::Shader, 0u, 0u, 0u,
+                Pack_Writer::read_file(path));
+        }
+
+        inline void add_raw(const std::string_view name,
+            const std::filesystem::path& path) noexcept
+        {
+            this->add(name, Pack_Kind::Raw, 0u, 0u, 0u,
+                Pack_Writer::read_file(path));
+        }
+
+        inline void write(const std::filesystem::path& path) noexcept
+        {
+            auto offset = Pack_Writer::align(sizeof(Pack_Header));
+            const auto toc_offset = offset;
+            offset = Pack_Writer::align(offset
+                + std::ranges::size(this->m_entries) * sizeof(Pack_Entry));
+
+            for (auto i = std::size_t{ 0 };
+                i < std::ranges::size(this->m_entries); ++i)
+            {
+                this->m_entries[i].offset = offset;
+                offset = Pack_Writer::align(
+                    offset + std::ranges::size(this->m_blobs[i]));
+            }
+
+            const auto header = Pack_Header{ c_pack_magic, c_pack_version,
+                static_cast<std::uint32_t>(std::ranges::size(this->m_entries)),
+                toc_offset };
+
+            auto file = std::ofstream{ path, std::ios::out | std::ios::binary };
+            assert(file.is_open());
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            Pack_Writer::pad(file, toc_offset);
+            file.write(reinterpret_cast<const char*>(this->m_entries.data()),
+                static_cast<std::streamsize>(
+                    std::ranges::size(this->m_entries) * sizeof(Pack_Entry)));
+
+            for (auto i = std::size_t{ 0 };
+                i < std::ranges::size(this->m_entries); ++i)
+            {
+                Pack_Writer::pad(file, this->m_entries[i].offset);
+                file.write(
+                    reinterpret_cast<const char*>(this->m_blobs[i].data()),
+                    static_cast<std::streamsize>(
+                        std::ranges::size(this->m_blobs[i])));
+            }
+
+            assert(file.good());
+        }
+
+    private:
+        struct Level
+        {
+            int width;
+            int height;
+            std::vector<unsigned char> texels;
+        };
+
+        [[nodiscard]] static constexpr int tiles(const int texels,
+            const int tile_size) noexcept
+        {
+            return (texels + tile_size - 1) / tile_size;
+        }
+
+        [[nodiscard]] static inline Level reduce(const Level& src) noexcept
+        {
+            const auto dw = std::max(src.width / 2, 1);
+            const auto dh = std::max(src.height / 2, 1);
+            auto dst = std::vector<unsigned char>(
+                static_cast<std::size_t>(dw * dh * 4));
+
+            const auto at = [&src](const int sx, const int sy,
+                const int c) noexcept
+            {
+                return static_cast<unsigned int>(
+                    src.texels[static_cast<std::size_t>(
+                        (sy * src.width + sx) * 4 + c)]);
+            };
+
+            for (auto y = 0; y < dh; ++y)
+            {
+                const auto sy0 = std::min(y * 2, src.height - 1);
+                const auto sy1 = std::min(y * 2 + 1, src.height - 1);
+                for (auto x = 0; x < dw; ++x)
+                {
+                    const auto sx0 = std::min(x * 2, src.width - 1);
+                    const auto sx1 = std::min(x * 2 + 1, src.width - 1);
+                    for (auto c = 0; c < 4; ++c)
+                    {
+                        dst[static_cast<std::size_t>((y * dw + x) * 4 + c)]
+                            = static_cast<unsigned char>((at(sx0, sy0, c)
+                                + at(sx1, sy0, c) + at(sx0, sy1, c)
+                                + at(sx1, sy1, c) + 2u) / 4u);
+                    }
+                }
+            }
+
+            return Level{ dw, dh, std::move(dst) };
+        }
+
+        inline void add_tile(const std::string_view name, const Level& level,
+            const int x0, const int y0, const int tile_size) noexcept
+        {
+            const auto w = std::min(tile_size, level.width - x0);
+            const auto h = std::min(tile_size, level.height - y0);
+
+            auto blob = std::vector<std::byte>(
+                static_cast<std::size_t>(w * h * 4));
+            for (auto y = 0; y < h; ++y)
+            {
+                const auto src = level.texels.data()
+                    + static_cast<std::size_t>(((y0 + y) * level.width + x0)
+                        * 4);
+                std::memcpy(blob.data() + static_cast<std::size_t>(y * w * 4),
+                    src, static_cast<std::size_t>(w * 4));
+            }
+
+            this->add(name, Pack_Kind::Texture, static_cast<std::uint32_t>(w),
+                static_cast<std::uint32_t>(h), 4u, std::move(blob));
+        }
+
+        inline void add(const std::string_view name, const Pack_Kind kind,
+            const std::uint32_t width, const std::uint32_t height,
+            const std::uint32_t channels,
+            std::vector<std::byte>&& blob) noexcept
+        {
+            auto entry = Pack_Entry{};
+            assert(std::ranges::size(name) < std::ranges::size(entry.name));
+
+            std::ranges::copy(name, std::ranges::begin(entry.name));
+            entry.kind = kind;
+            entry.width = width;
+            entry.height = height;
+            entry.channels = channels;
+            entry.size = std::ranges::size(blob);
+
+            this->m_entries.push_back(entry);
+            this->m_blobs.push_back(std::move(blob));
+        }
+
+        [[nodiscard]] static constexpr std::uint64_t align(
+            const std::uint64_t offset) noexcept
+        {
+            return (offset + c_pack_alignment - 1ull)
+                & ~(c_pack_alignment - 1ull);
+        }
+
+        static inline void pad(std::ofstream& file,
+            const std::uint64_t offset) noexcept
+        {
+            while (static_cast<std::uint64_t>(file.tellp()) < offset)
+            {
+                file.put('\0');
+            }
+        }
+
+        [[nodiscard]] static inline std::vector<std::byte> read_file(
+            const std::filesystem::path& path) noexcept
+        {
+            assert(std::filesystem::exists(path));
+
+            auto file = std::ifstream{ path, std::ios::in | std::ios::binary };
+            assert(file.is_open());
+
+            auto blob = std::vector<std::byte>(
+                std::filesystem::file_size(path));
+            file.read(reinterpret_cast<char*>(blob.data()),
+                static_cast<std::streamsize>(std::ranges::size(blob)));
+
+            return blob;
+        }
+
+        std::vector<Pack_Entry> m_entries;
+        std::vector<std::vector<std::byte>> m_blobs;
+    };
+}
@@ -0,0 +1,400 @@
+// Particle_System.cpp
+
+export module Eqx.OGL.Particle_System;
+
+import Eqx.OGL.Gpu_Memory;
+import Eqx.OGL.Shader_Program;
+import Eqx.OGL.Trace;
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glad/glad.hpp>;
+import <Eqx/TPL/glm/glm.hpp>;
+import Eqx.Lib;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    static_assert(std::same_as<GLuint, unsigned int>);
+
+    /*
+     * Colors are premultiplied, an alpha of 0 adds light instead of
+     * covering what is behind. Sizes are half extents in world units,
+     * stretch lengthens the quad along the velocity by that many seconds
+     * of travel. Velocity decays by exp(-drag) every second.
+     */
+    struct Particle_Style
+    {
+        glm::vec4 color_start = glm::vec4(1.0F, 1.0F, 1.0F, 1.0F);
+        glm::vec4 color_end = glm::vec4(0.0F, 0.0F, 0.0F, 0.0F);
+        float size_start = 1.0F;
+        float size_end = 1.0F;
+        float stretch = 0.0F;
+        float drag = 0.0F;
+        eqx::lib::Point<float> acceleration;
+    };
+
+    /*
+     * count particles spawned in a disc of radius around position, heading
+     * direction +- spread radians with a speed and life in seconds picked
+     * uniformly from their ranges.
+     */
+    struct Particle_Emission
+    {
+        eqx::lib::Point<float> position;
+        float direction = 0.0F;
+        float spread = std::numbers::pi_v<float>;
+        float speed_min = 0.0F;
+        float speed_max = 0.0F;
+        float life_min = 1.0F;
+        float life_max = 1.0F;
+        float radius = 0.0F;
+        std::uint32_t style = 0u;
+        std::uint32_t count = 1u;
+    };
+
+    /*
+     * Particles simulated entirely on the GPU.
+     *
+     * State lives in two vertex buffers of 28 byte records, position,
+     * velocity and age, life and style. Each update() runs the shader in
+     * Resources/Shaders/Particle/Update.glsl over every record of one
+     * buffer with the rasterizer off and captures the result into the
+     * other through transform feedback, then the two swap. New particles
+     * take the slots after the last ones in ring order, so the oldest are
+     * recycled first once the ring is full. draw() is one instanced
+     * triangle strip over the whole ring, dead records are culled in the
+     * vertex shader. Neither touches particle data on the CPU.
+     *
+     * emit() only queues and may be called from any thread, update() and
+     * draw() need the context. Once nothing emitted can still be alive
+     * both skip their pass entirely. Liveness is judged in simulation time,
+     * the sum of the dt passed to update(), so it agrees with the ages the
+     * shader advances however dt relates to wall time. Draw with
+     * blend_premultiplied(true) and set u_view and u_proj on
+     * get_draw_program().
+     */
+    class Particle_System
+    {
+    public:
+        static constexpr auto c_max_styles = 8ull;
+        static constexpr auto c_max_emissions = 32ull;
+
+        Particle_System(const Particle_System&) = delete;
+        Particle_System(Particle_System&&) = delete;
+        Particle_System& operator= (const Particle_System&) = delete;
+        Particle_System& operator= (Particle_System&&) = delete;
+
+        explicit inline Particle_System(
+            const std::size_t capacity = 65'536ull) noexcept
+            :
+            m_capacity(capacity),
+            m_buffers(),
+            m_update_arrays(),
+            m_draw_arrays(),
+            m_current(0ull),
+            m_head(0ull),
+            m_seed(0u),
+            m_update_program(Shader_Program::from_feedback_file(
+                "./Resources/Shaders/Particle/Update.glsl"sv,
+                c_varyings)),
+            m_draw_program(Shader_Program::from_files(
+                "./Resources/Shaders/Particle/Vertex.glsl"sv,
+                "./Resources/Shaders/Particle/Fragment.glsl"sv)),
+            m_mutex(),
+            m_queued(),
+            m_time(0.0),
+            m_active_until(0.0),
+            m_emitted(0ull),
+            m_updates(0ull)
+        {
+            // Slots are passed to the update shader as floats.
+            assert(capacity > 0ull && capacity <= (1ull << 24));
+
+            glGenBuffers(2, this->m_buffers.data());
+            glGenVertexArrays(2, this->m_update_arrays.data());
+            glGenVertexArrays(2, this->m_draw_arrays.data());
+
+            // Zeroed records have age == life, so every slot starts dead.
+            const auto zeros = std::vector<Record>(capacity, Record{});
+            for (auto i = 0ull; i < 2ull; ++i)
+            {
+                glBindBuffer(GL_ARRAY_BUFFER, this->m_buffers[i]);
+                glBufferData(GL_ARRAY_BUFFER, this->get_buffer_bytes(),
+                    zeros.data(), GL_DYNAMIC_COPY);
+                Gpu_Memory::track(Gpu_Memory::Category::Vertex_Buffer,
+                    this->m_buffers[i], this->get_buffer_bytes());
+
+                glBindVertexArray(this->m_update_arrays[i]);
+                Particle_System::set_attributes(0u);
+
+                glBindVertexArray(this->m_draw_arrays[i]);
+                Particle_System::set_attributes(1u);
+            }
+            glBindVertexArray(0u);
+
+            for (auto i = 0ull; i < c_max_styles; ++i)
+            {
+                this->set_style(static_cast<std::uint32_t>(i),
+                    Particle_Style{});
+            }
+            this->m_update_program.set_int("u_capacity"sv,
+                static_cast<int>(capacity));
+        }
+
+        inline ~Particle_System() noexcept
+        {
+            for (const auto buffer : this->m_buffers)
+            {
+                Gpu_Memory::untrack(Gpu_Memory::Category::Vertex_Buffer,
+                    buffer);
+            }
+            glDeleteVertexArrays(2, this->m_draw_arrays.data());
+            glDeleteVertexArrays(2, this->m_update_arrays.data());
+            glDeleteBuffers(2, this->m_buffers.data());
+        }
+
+        inline void set_style(const std::uint32_t index,
+            const Particle_Style& style) noexcept
+        {
+            assert(index < c_max_styles);
+
+            const auto element = [index](const std::string_view name)
+                noexcept
+            {
+                return std::format("{}[{}]"sv, name, index);
+            };
+
+            const auto motion = std::array<glm::vec4, 1>{ glm::vec4(
+                style.drag, style.acceleration.get_x(),
+                style.acceleration.get_y(), 0.0F) };
+            this->m_update_program.set_vec4s(
+                element("u_style_motion"sv), motion);
+
+            const auto start = std::array<glm::vec4, 1>{ style.color_start };
+            const auto end = std::array<glm::vec4, 1>{ style.color_end };
+            const auto shape = std::array<glm::vec4, 1>{ glm::vec4(
+                style.size_start, style.size_end, style.stretch, 0.0F) };
+            this->m_draw_program.set_vec4s(
+                element("u_style_color_start"sv), start);
+            this->m_draw_program.set_vec4s(
+                element("u_style_color_end"sv), end);
+            this->m_draw_program.set_vec4s(
+                element("u_style_shape"sv), shape);
+        }
+
+        // Spawned by the next update(), or a later one past
+        // c_max_emissions queued emissions.
+        inline void emit(const Particle_Emission& emission) noexcept
+        {
+            assert(emission.style < c_max_styles);
+            assert(emission.life_min > 0.0F
+                && emission.life_min <= emission.life_max);
+            assert(emission.speed_min <= emission.speed_max);
+
+            if (emission.count == 0u)
+            {
+                return;
+            }
+
+            auto lock = std::scoped_lock{ this->m_mutex };
+            this->m_queued.push_back(emission);
+        }
+
+        inline void update(const float dt) noexcept
+        {
+            assert(dt >= 0.0F);
+
+            auto origins = std::array<glm::vec4, c_max_emissions>{};
+            auto shapes = std::array<glm::vec4, c_max_emissions>{};
+            auto ranges = std::array<glm::vec4, c_max_emissions>{};
+            auto emissions = 0ull;
+            auto spawn = 0ull;
+            {
+                auto lock = std::scoped_lock{ this->m_mutex };
+                if (!this->active_locked())
+                {
+                    return;
+                }
+
+                // Particles spawned by this pass start at age 0 and age by
+                // the dt of every later one.
+                this->m_time += static_cast<double>(dt);
+
+                // More particles than the ring holds would only overwrite
+                // each other in the same pass.
+                for (; emissions < std::ranges::size(this->m_queued)
+                    && emissions < c_max_emissions
+                    && spawn < this->m_capacity; ++emissions)
+                {
+                    const auto& emission = this->m_queued[emissions];
+                    const auto count = std::min<std::size_t>(
+                        emission.count, this->m_capacity - spawn);
+                    origins[emissions] = glm::vec4(
+                        emission.position.get_x(),
+                        emission.position.get_y(), emission.radius,
+                        static_cast<float>(emission.style));
+                    shapes[emissions] = glm::vec4(emission.direction,
+                        emission.spread, emission.speed_min,
+                        emission.speed_max);
+                    ranges[emissions] = glm::vec4(static_cast<float>(spawn),
+                        static_cast<float>(count), emission.life_min,
+                        emission.life_max);
+                    spawn += count;
+
+                    this->m_active_until = std::max(this->m_active_until,
+                        this->m_time + static_cast<double>(emission.life_max));
+                }
+                this->m_queued.erase(std::ranges::begin(this->m_queued),
+                    std::ranges::begin(this->m_queued)
+                        + static_cast<std::ptrdiff_t>(emissions));
+            }
+
+            const auto zone = Zone{ "Particle_System::update"sv };
+            this->m_update_program.set_float("u_dt"sv, dt);
+            this->m_update_program.set_int("u_seed"sv,
+                static_cast<int>(this->m_seed++ & 0x7FFF'FFFFu));
+            this->m_update_program.set_int("u_spawn_first"sv,
+                static_cast<int>(this->m_head));
+            this->m_update_program.set_int("u_spawn_count"sv,
+                static_cast<int>(spawn));
+            this->m_update_program.set_int("u_emissions"sv,
+                static_cast<int>(emissions));
+            if (emissions > 0ull)
+            {
+                this->m_update_program.set_vec4s("u_emission_origin"sv,
+                    std::span{ origins }.first(emissions));
+                this->m_update_program.set_vec4s("u_emission_shape"sv,
+                    std::span{ shapes }.first(emissions));
+                this->m_update_program.set_vec4s("u_emission_range"sv,
+                    std::span{ ranges }.first(emissions));
+            }
+
+            const auto next = 1ull - this->m_current;
+            glEnable(GL_RASTERIZER_DISCARD);
+            glBindVertexArray(this->m_update_arrays[this->m_current]);
+            glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0u,
+                this->m_buffers[next]);
+            glBeginTransformFeedback(GL_POINTS);
+            glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(this->m_capacity));
+            glEndTransformFeedback();
+            glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0u, 0u);
+            glBindVertexArray(0u);
+            glDisable(GL_RASTERIZER_DISCARD);
+
+            this->m_current = next;
+            this->m_head = (this->m_head + spawn) % this->m_capacity;
+            this->m_emitted += spawn;
+            ++this->m_updates;
+        }
+
+        inline void draw() const noexcept
+        {
+            if (!this->active())
+            {
+                return;
+            }
+
+            const auto zone = Zone{ "Particle_System::draw"sv };
+            this->m_draw_program.enable();
+            glBindVertexArray(this->m_draw_arrays[this->m_current]);
+            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4,
+                static_cast<GLsizei>(this->m_capacity));
+            glBindVertexArray(0u);
+        }
+
+        // Whether anything emitted may still be alive or waits to spawn.
+        [[nodiscard]] inline bool active() const noexcept
+        {
+            auto lock = std::scoped_lock{ this->m_mutex };
+            return this->active_locked();
+        }
+
+        [[nodiscard]] constexpr const Shader_Program&
+            get_draw_program() const noexcept
+        {
+            return this->m_draw_program;
+        }
+
+        [[nodiscard]] constexpr std::size_t get_capacity() const noexcept
+        {
+            return this->m_capacity;
+        }
+
+        // Particles spawned since construction.
+        [[nodiscard]] constexpr unsigned long long
+            get_emitted() const noexcept
+        {
+            return this->m_emitted;
+        }
+
+        [[nodiscard]] constexpr unsigned long long
+            get_updates() const noexcept
+        {
+            return this->m_updates;
+        }
+
+        [[nodiscard]] static consteval std::size_t
+            get_record_bytes() noexcept
+        {
+            return sizeof(Record);
+        }
+
+    private:
+        struct Record
+        {
+            std::array<float, 2> position;
+            std::array<float, 2> velocity;
+            std::array<float, 3> state;
+        };
+        static_assert(sizeof(Record) == 28ull);
+
+        static constexpr auto c_varyings = std::array<const char*, 3>{
+            "o_position", "o_velocity", "o_state" };
+
+        // Update arrays read one record per vertex, draw arrays one per
+        // instance.
+        static inline void set_attributes(const GLuint divisor) noexcept
+        {
+            const auto attribute = [divisor](const GLuint index,
+                const GLint size, const std::size_t offset) noexcept
+            {
+                glEnableVertexAttribArray(index);
+                glVertexAttribPointer(index, size, GL_FLOAT, GL_FALSE,
+                    sizeof(Record), (void*)offset);
+                glVertexAttribDivisor(index, divisor);
+            };
+
+            attribute(0u, 2, 0ull);
+            attribute(1u, 2, 8ull);
+            attribute(2u, 3, 16ull);
+        }
+
+        [[nodiscard]] inline bool active_locked() const noexcept
+        {
+            return !std::ranges::empty(this->m_queued)
+                || this->m_time < this->m_active_until;
+        }
+
+        [[nodiscard]] constexpr std::size_t get_buffer_bytes() const noexcept
+        {
+            return this->m_capacity * sizeof(Record);
+        }
+
+        std::size_t m_capacity;
+        std::array<GLuint, 2> m_buffers;
+        std::array<GLuint, 2> m_update_arrays;
+        std::array<GLuint, 2> m_draw_arrays;
+        std::size_t m_current;
+        std::size_t m_head;
+        std::uint32_t m_seed;
+        Shader_Program m_update_program;
+        Shader_Program m_draw_program;
+        mutable std::mutex m_mutex;
+        std::vector<Particle_Emission> m_queued;
+        double m_time;
+        double m_active_until;
+        unsigned long long m_emitted;
+        unsigned long long m_updates;
+    };
+}
@@ -0,0 +1,276 @@
+// Render_Queue.cpp
+
+export module Eqx.OGL.Render_Queue;
+
+import Eqx.OGL.Sampler;
+import Eqx.OGL.Shader_Program;
+import Eqx.OGL.Sprite_Batch;
+import Eqx.OGL.Texture;
+import Eqx.OGL.Trace;
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glad/glad.hpp>;
+import Eqx.Lib;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    static_assert(std::same_as<GLuint, unsigned int>);
+
+    /*
+     * 64 bit draw order key, most significant first:
+     *
+     *   opaque:      layer:8 | 0:1 | program:12 | texture:16 | depth:24
+     *                | sampler:3
+     *   translucent: layer:8 | 1:1 | ~depth:24 | program:12 | texture:16
+     *                | sampler:3
+     *
+     * Within a layer opaque draws come first, grouped by program then
+     * texture. Translucent draws follow back to front, depth in [0, 1] with
+     * 1 the furthest, so blending stays correct. The sampler only orders
+     * draws sharing everything else, so opaque draws of one texture at
+     * different depths may still alternate samplers. GL names are truncated
+     * to their field, which only costs grouping once names outgrow it, a
+     * Sampler_Cache rarely holds more than a handful.
+     */
+    struct Render_Key
+    {
+        [[nodiscard]] static constexpr std::uint64_t make(
+            const std::uint8_t layer, const bool translucent,
+            const GLuint program, const GLuint texture,
+            const GLuint sampler, const float depth) noexcept
+        {
+            const auto l = static_cast<std::uint64_t>(layer);
+            const auto p = static_cast<std::uint64_t>(program & 0xFFFu);
+            const auto t = static_cast<std::uint64_t>(texture & 0xFFFFu);
+            const auto s = static_cast<std::uint64_t>(sampler & 0x7u);
+            const auto d = static_cast<std::uint64_t>(
+                std::clamp(depth, 0.0F, 1.0F) * 16'777'215.0F);
+
+            return translucent
+                ? (l << 56) | (1ull << 55) | ((0xFF'FFFFull - d) << 31)
+                    | (p << 19) | (t << 3) | s
+                : (l << 56) | (p << 43) | (t << 27) | (d << 3) | s;
+        }
+
+        [[nodiscard]] static constexpr std::uint8_t get_layer(
+            const std::uint64_t key) noexcept
+        {
+            return static_cast<std::uint8_t>(key >> 56);
+        }
+
+        [[nodiscard]] static constexpr bool translucent(
+            const std::uint64_t key) noexcept
+        {
+            return ((key >> 55) & 1ull) == 1ull;
+        }
+    };
+
+    struct Render_Queue_Stats
+    {
+        std::size_t commands;
+        std::size_t submitted_program_changes;
+        std::size_t submitted_texture_changes;
+        std::size_t program_changes;
+        std::size_t texture_changes;
+    };
+
+    /*
+     * Textured quads submitted in any order, drawn sorted by Render_Key.
+     *
+     * sort() is an LSD radix sort over the keys, a byte per pass, passes
+     * where every key shares the byte are skipped. It is stable, so equal
+     * keys keep their submission order. execute() walks the sorted
+     * commands through a Sprite_Batch, enabling a program only when it
+     * changes. The stats compare the program and texture changes the
+     * submission order would have cost with the ones actually made.
+     */
+    class Render_Queue
+    {
+    public:
+        Render_Queue(const Render_Queue&) = delete;
+        Render_Queue& operator= (const Render_Queue&) = delete;
+        Render_Queue(Render_Queue&&) = default;
+        Render_Queue& operator= (Render_Queue&&) = default;
+        ~Render_Queue() = default;
+
+        explicit inline Render_Queue() noexcept
+            :
+            m_commands(),
+            m_order(),
+            m_scratch(),
+            m_sorted(false),
+            m_stats()
+        {
+        }
+
+        inline void submit(const std::uint8_t layer, const bool translucent,
+            const float depth, const Shader_Program& program,
+            const Texture& texture, const Sampler& sampler,
+            const eqx::lib::Polygon<float, 4>& quad,
+            const Uv_Rect& uv = Uv_Rect::full()) noexcept
+        {
+            const auto key = Render_Key::make(layer, translucent,
+                program.get_id(), texture.get_id(), sampler.get_id(), depth);
+            this->m_order.push_back(Entry{ key,
+                static_cast<std::uint32_t>(std::ranges::size(
+                    this->m_commands)) });
+            this->m_commands.push_back(
+                Command{ &program, &texture, &sampler, quad, uv });
+            this->m_sorted = false;
+        }
+
+        inline void sort() noexcept
+        {
+            if (this->m_sorted)
+            {
+                return;
+            }
+
+            const auto zone = Zone{ "Render_Queue::sort"sv };
+            const auto [programs, textures] = this->count_changes();
+            this->m_stats.submitted_program_changes = programs;
+            this->m_stats.submitted_texture_changes = textures;
+
+            Render_Queue::radix_sort(this->m_order, this->m_scratch);
+            this->m_sorted = true;
+        }
+
+        inline void execute(Sprite_Batch& batch) noexcept
+        {
+            this->sort();
+
+            const auto zone = Zone{ "Render_Queue::execute"sv };
+            const auto [programs, textures] = this->count_changes();
+            this->m_stats.commands = std::ranges::size(this->m_commands);
+            this->m_stats.program_changes = programs;
+            this->m_stats.texture_changes = textures;
+
+            auto program = static_cast<const Shader_Program*>(nullptr);
+            for (const auto& entry : this->m_order)
+            {
+                const auto& command = this->m_commands[entry.index];
+                if (command.program != program)
+                {
+                    batch.flush();
+                    program = command.program;
+                    program->enable();
+                }
+
+                batch.submit(command.quad, *command.texture,
+                    *command.sampler, command.uv);
+            }
+            batch.flush();
+
+            this->clear();
+        }
+
+        inline void clear() noexcept
+        {
+            this->m_commands.clear();
+            this->m_order.clear();
+            this->m_sorted = false;
+        }
+
+        [[nodiscard]] constexpr const Render_Queue_Stats&
+            get_stats() const noexcept
+        {
+            return this->m_stats;
+        }
+
+        [[nodiscard]] constexpr std::size_t get_size() const noexcept
+        {
+            return std::ranges::size(this->m_commands);
+        }
+
+        // Keys in draw order once sorted, in submission order before.
+        [[nodiscard]] inline std::vector<std::uint64_t>
+            get_keys() const noexcept
+        {
+            auto keys = std::vector<std::uint64_t>{};
+            keys.reserve(std::ranges::size(this->m_order));
+            std::ranges::transform(this->m_order, std::back_inserter(keys),
+                &Entry::key);
+            return keys;
+        }
+
+    private:
+        struct Command
+        {
+            const Shader_Program* program;
+            const Texture* texture;
+            const Sampler* sampler;
+            eqx::lib::Polygon<float, 4> quad;
+            Uv_Rect uv;
+        };
+
+        struct Entry
+        {
+            std::uint64_t key;
+            std::uint32_t index;
+        };
+
+        static inline void radix_sort(std::vector<Entry>& entries,
+            std::vector<Entry>& scratch) noexcept
+        {
+            scratch.resize(std::ranges::size(entries));
+
+            for (auto shift = 0; shift < 64; shift += 8)
+            {
+                auto counts = std::array<std::size_t, 256>{};
+                for (const auto& entry : entries)
+                {
+                    ++counts[(entry.key >> shift) & 0xFFull];
+                }
+
+                if (std::ranges::find(counts, std::ranges::size(entries))
+                    != std::ranges::end(counts))
+                {
+                    continue;
+                }
+
+                std::exclusive_scan(std::ranges::begin(counts),
+                    std::ranges::end(counts), std::ranges::begin(counts),
+                    std::size_t{ 0 });
+                for (const auto& entry : entries)
+                {
+                    scratch[counts[(entry.key >> shift) & 0xFFull]++] = entry;
+                }
+
+                std::swap(entries, scratch);
+            }
+        }
+
+        [[nodiscard]] inline std::pair<std::size_t, std::size_t>
+            count_changes() const noexcept
+        {
+            auto programs = std::size_t{ 0 };
+            auto textures = std::size_t{ 0 };
+            auto program = static_cast<const Shader_Program*>(nullptr);
+            auto texture = static_cast<const Texture*>(nullptr);
+            for (const auto& entry : this->m_order)
+            {
+                const auto& command = this->m_commands[entry.index];
+                if (command.program != program)
+                {
+                    program = command.program;
+                    ++programs;
+                }
+                if (command.texture != texture)
+                {
+                    texture = command.texture;
+                    ++textures;
+                }
+            }
+
+            return std::make_pair(programs, textures);
+        }
+
+        std::vector<Command> m_commands;
+        std::vector<Entry> m_order;
+        std::vector<Entry> m_scratch;
+        bool m_sorted;
+        Render_Queue_Stats m_stats;
+    };
+}
@@ -0,0 +1,222 @@
+// Render_Thread.cpp
+
+export module Eqx.OGL.Render_Thread;
+
+import <Eqx/std.hpp>;
+import Eqx.OGL.Trace;
+import Eqx.OGL.Window;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    /*
+     * Single producer, single consumer triple buffer. The writer fills
+     * get_write_buffer() and publish()es it, the reader calls update() and
+     * then reads get_read_buffer(). Neither side ever waits on the other,
+     * the reader simply sees the newest published value.
+     */
+    template <typename T>
+    class Triple_Buffer
+    {
+    public:
+        Triple_Buffer(const Triple_Buffer&) = delete;
+        Triple_Buffer(Triple_Buffer&&) = delete;
+        Triple_Buffer& operator= (const Triple_Buffer&) = delete;
+        Triple_Buffer& operator= (Triple_Buffer&&) = delete;
+        ~Triple_Buffer() = default;
+
+        explicit inline Triple_Buffer(const T& value = T{}) noexcept
+            :
+            m_slots{ Slot{ value }, Slot{ value }, Slot{ value } },
+            m_back(0u),
+            m_middle(1u),
+            m_front(2u)
+        {
+        }
+
+        [[nodiscard]] constexpr T& get_write_buffer() noexcept
+        {
+            return this->m_slots[this->m_back].value;
+        }
+
+        inline void publish() noexcept
+        {
+            this->m_back = static_cast<std::uint8_t>(
+                this->m_middle.exchange(this->m_back | c_dirty,
+                    std::memory_order_acq_rel) & c_index);
+        }
+
+        /*
+         * Returns true if a newer value was published since the last call.
+         */
+        [[nodiscard]] inline bool update() noexcept
+        {
+            if ((this->m_middle.load(std::memory_order_relaxed) & c_dirty)
+                == 0u)
+            {
+                return false;
+            }
+
+            this->m_front = static_cast<std::uint8_t>(
+                this->m_middle.exchange(this->m_front,
+                    std::memory_order_acq_rel) & c_index);
+            return true;
+        }
+
+        [[nodiscard]] constexpr const T& get_read_buffer() const noexcept
+        {
+            return this->m_slots[this->m_front].value;
+        }
+
+    private:
+        struct Slot
+        {
+            alignas(64) T value;
+        };
+
+        static constexpr auto c_index = std::uint8_t{ 0b011 };
+        static constexpr auto c_dirty = std::uint8_t{ 0b100 };
+
+        std::array<Slot, 3> m_slots;
+        alignas(64) std::uint8_t m_back;
+        alignas(64) std::atomic<std::uint8_t> m_middle;
+        alignas(64) std::uint8_t m_front;
+    };
+
+    /*
+     * Owns the Window's GL context for its lifetime. The simulation thread
+     * writes immutable frames into get_write_buffer() and publish()es them,
+     * the render thread clears, renders the newest frame and swaps, pacing
+     * itself on vsync. On demand it only renders frames published since
+     * the last one and sleeps in between, so a producer that stops
+     * publishing while nothing changes stops the GPU work too. All GL
+     * objects used by render must only be touched from inside it until the
+     * Render_Thread is destroyed, which hands the context back to the
+     * constructing thread.
+     */
+    template <typename T_Frame>
+    class Render_Thread
+    {
+    public:
+        Render_Thread(const Render_Thread&) = delete;
+        Render_Thread(Render_Thread&&) = delete;
+        Render_Thread& operator= (const Render_Thread&) = delete;
+        Render_Thread& operator= (Render_Thread&&) = delete;
+
+        explicit inline Render_Thread(Window& window,
+            std::function<void(const T_Frame&)> render) noexcept
+            :
+            m_window(&window),
+            m_render(std::move(render)),
+            m_buffer(),
+            m_signal(0u),
+            m_on_demand(false),
+            m_frames(0ull),
+            m_fps(0.0F),
+            m_thread()
+        {
+            this->m_window->release_context();
+            this->m_thread = std::jthread{ [this](std::stop_token token)
+                {
+                    this->work(token);
+                } };
+        }
+
+        inline ~Render_Thread() noexcept
+        {
+            this->m_thread.request_stop();
+            this->signal();
+            this->m_thread.join();
+            this->m_window->make_context_current();
+        }
+
+        [[nodiscard]] constexpr T_Frame& get_write_buffer() noexcept
+        {
+            return this->m_buffer.get_write_buffer();
+        }
+
+        inline void publish() noexcept
+        {
+            this->m_buffer.publish();
+            this->signal();
+        }
+
+        inline void set_on_demand(const bool on_demand) noexcept
+        {
+            this->m_on_demand.store(on_demand, std::memory_order_relaxed);
+            this->signal();
+        }
+
+        [[nodiscard]] inline unsigned long long get_frames() const noexcept
+        {
+            return this->m_frames.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] inline float get_fps() const noexcept
+        {
+            return this->m_fps.load(std::memory_order_relaxed);
+        }
+
+    private:
+        inline void work(const std::stop_token& token) noexcept
+        {
+            this->m_window->make_context_current();
+            Trace::set_thread_name("Render"sv);
+
+            auto frame_timer = Frame_Timer{};
+            auto ready = false;
+            while (!token.stop_requested())
+            {
+                // Read before update() so a publish in between ends the wait.
+                const auto signal =
+                    this->m_signal.load(std::memory_order_acquire);
+                const auto fresh = this->m_buffer.update();
+                const auto on_demand =
+                    this->m_on_demand.load(std::memory_order_relaxed);
+                ready = fresh || ready;
+                if (!ready || (on_demand && !fresh)) [[unlikely]]
+                {
+                    if (on_demand)
+                    {
+                        this->m_signal.wait(signal, std::memory_order_acquire);
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                    continue;
+                }
+
+                {
+                    const auto zone = Zone{ "Render_Thread::render"sv };
+                    this->m_window->clear();
+                    this->m_render(this->m_buffer.get_read_buffer());
+                }
+                this->m_window->swap();
+
+                frame_timer.update();
+                this->m_frames.fetch_add(1ull, std::memory_order_relaxed);
+                this->m_fps.store(frame_timer.get_fps(),
+                    std::memory_order_relaxed);
+            }
+
+            this->m_window->release_context();
+        }
+
+        inline void signal() noexcept
+        {
+            this->m_signal.fetch_add(1u, std::memory_order_release);
+            this->m_signal.notify_one();
+        }
+
+        Window* m_window;
+        std::function<void(const T_Frame&)> m_render;
+        Triple_Buffer<T_Frame> m_buffer;
+        std::atomic<std::uint32_t> m_signal;
+        std::atomic<bool> m_on_demand;
+        std::atomic<unsigned long long> m_frames;
+        std::atomic<float> m_fps;
+        std::jthread m_thread;
+    };
+}
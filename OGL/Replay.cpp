@@ -0,0 +1,401 @@
+// Replay.cpp
+
+export module Eqx.OGL.Replay;
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glfw/glfw.hpp>;
+import Eqx.Lib;
+import Eqx.OGL.Input;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    /*
+     * The input one simulation tick consumes. The cursor is in whatever
+     * space the caller chooses, world space keeps a recording independent
+     * of the window size.
+     */
+    struct Input_Frame
+    {
+        std::bitset<GLFW_KEY_LAST + 1> keys;
+        std::bitset<GLFW_MOUSE_BUTTON_LAST + 1> buttons;
+        eqx::lib::Point<float> cursor;
+        eqx::lib::Point<float> scroll;
+
+        [[nodiscard]] static inline Input_Frame capture(
+            const Input_State& state,
+            const eqx::lib::Point<float>& cursor) noexcept
+        {
+            auto frame = Input_Frame{};
+            for (auto key = 0; key <= GLFW_KEY_LAST; ++key)
+            {
+                frame.keys.set(static_cast<std::size_t>(key),
+                    state.key_down(key));
+            }
+            for (auto button = 0; button <= GLFW_MOUSE_BUTTON_LAST; ++button)
+            {
+                frame.buttons.set(static_cast<std::size_t>(button),
+                    state.mouse_button_down(button));
+            }
+            frame.cursor = cursor;
+            frame.scroll = state.get_scroll();
+
+            return frame;
+        }
+
+        template <typename T_Key>
+            requires std::is_enum_v<T_Key>
+        [[nodiscard]] inline bool key_down(const T_Key key) const noexcept
+        {
+            return this->keys.test(static_cast<std::size_t>(key));
+        }
+
+        template <typename T_Key>
+            requires std::is_enum_v<T_Key>
+        [[nodiscard]] inline bool key_up(const T_Key key) const noexcept
+        {
+            return !this->key_down(key);
+        }
+
+        template <typename T_Button>
+            requires std::is_enum_v<T_Button>
+        [[nodiscard]] inline bool mouse_button_down(
+            const T_Button button) const noexcept
+        {
+            return this->buttons.test(static_cast<std::size_t>(button));
+        }
+    };
+
+    /*
+     * Recording layout, all integers little endian:
+     *
+     *     "EQXINPUT", u32 version, f32 tick
+     *     per tick: u8 flags, then only the parts the flags name
+     *         0x1 keys:    u16 count, count x u16 key that toggled
+     *         0x2 buttons: u8 button bits
+     *         0x4 cursor:  f32 x, f32 y
+     *         0x8 scroll:  f32 x, f32 y
+     *
+     * A tick where nothing changed costs a single byte.
+     */
+    class Input_Recorder
+    {
+    public:
+        static constexpr auto c_magic = "EQXINPUT"sv;
+        static constexpr auto c_version = std::uint32_t{ 1 };
+
+        Input_Recorder(const Input_Recorder&) = delete;
+        Input_Recorder(Input_Recorder&&) = default;
+        Input_Recorder& operator= (const Input_Recorder&) = delete;
+        Input_Recorder& operator= (Input_Recorder&&) = default;
+
+        explicit inline Input_Recorder(std::filesystem::path path,
+            const float tick) noexcept
+            :
+            m_path(std::move(path)),
+            m_bytes(),
+            m_last(),
+            m_ticks(0ull)
+        {
+            this->m_bytes.insert(std::ranges::end(this->m_bytes),
+                std::ranges::begin(c_magic), std::ranges::end(c_magic));
+            this->put(c_version);
+            this->put(tick);
+        }
+
+        inline ~Input_Recorder() noexcept
+        {
+            if (!this->m_path.empty())
+            {
+                [[maybe_unused]] const auto ok = this->save();
+            }
+        }
+
+        inline void record(const Input_Frame& frame) noexcept
+        {
+            const auto toggled = frame.keys ^ this->m_last.keys;
+            const auto flags = static_cast<std::uint8_t>(
+                (toggled.any() ? 0x1u : 0u)
+                | (frame.buttons != this->m_last.buttons ? 0x2u : 0u)
+                | (!Input_Recorder::same(frame.cursor, this->m_last.cursor)
+                    ? 0x4u : 0u)
+                | (!Input_Recorder::same(frame.scroll,
+                    eqx::lib::Point<float>::origin()) ? 0x8u : 0u));
+            this->put(flags);
+
+            if ((flags & 0x1u) != 0u)
+            {
+                this->put(static_cast<std::uint16_t>(toggled.count()));
+                for (auto key = std::size_t{ 0 }; key < toggled.size(); ++key)
+                {
+                    if (toggled.test(key))
+                    {
+                        this->put(static_cast<std::uint16_t>(key));
+                    }
+                }
+            }
+
+            if ((flags & 0x2u) != 0u)
+            {
+                this->put(static_cast<std::uint8_t>(frame.buttons.to_ulong()));
+            }
+
+            if ((flags & 0x4u) != 0u)
+            {
+                this->put(frame.cursor.get_x());
+                this->put(frame.cursor.get_y());
+            }
+
+            if ((flags & 0x8u) != 0u)
+            {
+                this->put(frame.scroll.get_x());
+                this->put(frame.scroll.get_y());
+            }
+
+            this->m_last = frame;
+            ++this->m_ticks;
+        }
+
+        /*
+         * Writes everything recorded so far, the destructor saves too.
+         */
+        [[nodiscard]] inline bool save() const noexcept
+        {
+            auto file = std::ofstream{ this->m_path, std::ios::binary };
+            file.write(reinterpret_cast<const char*>(
+                std::ranges::data(this->m_bytes)),
+                static_cast<std::streamsize>(std::ranges::size(this->m_bytes)));
+            return static_cast<bool>(file);
+        }
+
+        [[nodiscard]] constexpr unsigned long long get_ticks() const noexcept
+        {
+            return this->m_ticks;
+        }
+
+        [[nodiscard]] inline std::size_t get_bytes() const noexcept
+        {
+            return std::ranges::size(this->m_bytes);
+        }
+
+    private:
+        [[nodiscard]] static constexpr bool same(
+            const eqx::lib::Point<float>& p1,
+            const eqx::lib::Point<float>& p2) noexcept
+        {
+            return p1.get_x() == p2.get_x() && p1.get_y() == p2.get_y();
+        }
+
+        template <typename T>
+        inline void put(const T value) noexcept
+        {
+            static_assert(std::endian::native == std::endian::little);
+
+            const auto bytes =
+                std::bit_cast<std::array<unsigned char, sizeof(T)>>(value);
+            this->m_bytes.insert(std::ranges::end(this->m_bytes),
+                std::ranges::begin(bytes), std::ranges::end(bytes));
+        }
+
+        std::filesystem::path m_path;
+        std::vector<unsigned char> m_bytes;
+        Input_Frame m_last;
+        unsigned long long m_ticks;
+    };
+
+    /*
+     * Plays back an Input_Recorder file. A file that is missing, has the
+     * wrong magic or version or a tick that is not positive is rejected,
+     * valid() is false and the recording is empty. A truncated or corrupt
+     * tick ends the recording there and clears valid().
+     */
+    class Input_Player
+    {
+    public:
+        Input_Player(const Input_Player&) = default;
+        Input_Player(Input_Player&&) = default;
+        Input_Player& operator= (const Input_Player&) = default;
+        Input_Player& operator= (Input_Player&&) = default;
+        ~Input_Player() = default;
+
+        explicit inline Input_Player(
+            const std::filesystem::path& path) noexcept
+            :
+            m_bytes(),
+            m_offset(0ull),
+            m_tick(0.0F),
+            m_frame(),
+            m_valid(false)
+        {
+            auto file = std::ifstream{ path, std::ios::binary };
+            if (!file)
+            {
+                return;
+            }
+
+            this->m_bytes.assign(std::istreambuf_iterator<char>{ file },
+                std::istreambuf_iterator<char>{});
+
+            const auto magic = Input_Recorder::c_magic;
+            if (std::ranges::size(this->m_bytes) < std::ranges::size(magic)
+                || !std::ranges::equal(
+                    std::span{ this->m_bytes }.first(
+                        std::ranges::size(magic)),
+                    magic, {}, [](const char c) noexcept
+                    {
+                        return static_cast<unsigned char>(c);
+                    }))
+            {
+                this->m_bytes.clear();
+                return;
+            }
+            this->m_offset = std::ranges::size(magic);
+
+            const auto version = this->get<std::uint32_t>();
+            const auto tick = this->get<float>();
+            if (version != Input_Recorder::c_version || !tick.has_value()
+                || !std::isfinite(tick.value()) || tick.value() <= 0.0F)
+            {
+                this->m_bytes.clear();
+                this->m_offset = 0ull;
+                return;
+            }
+
+            this->m_tick = tick.value();
+            this->m_valid = true;
+        }
+
+        /*
+         * The next tick's input, nullopt once the recording is exhausted.
+         */
+        [[nodiscard]] inline std::optional<Input_Frame> next() noexcept
+        {
+            if (this->done())
+            {
+                return std::nullopt;
+            }
+
+            // Decoded into a copy so a corrupt tick changes nothing.
+            auto frame = this->m_frame;
+            const auto flags = this->get<std::uint8_t>();
+            if (!flags.has_value() || (flags.value() & 0xF0u) != 0u)
+            {
+                return this->reject();
+            }
+
+            if ((flags.value() & 0x1u) != 0u)
+            {
+                const auto count = this->get<std::uint16_t>();
+                if (!count.has_value())
+                {
+                    return this->reject();
+                }
+
+                for (auto i = 0; i < count.value(); ++i)
+                {
+                    const auto key = this->get<std::uint16_t>();
+                    if (!key.has_value() || key.value() >= frame.keys.size())
+                    {
+                        return this->reject();
+                    }
+                    frame.keys.flip(key.value());
+                }
+            }
+
+            if ((flags.value() & 0x2u) != 0u)
+            {
+                const auto buttons = this->get<std::uint8_t>();
+                if (!buttons.has_value())
+                {
+                    return this->reject();
+                }
+                frame.buttons = decltype(frame.buttons){ buttons.value() };
+            }
+
+            if ((flags.value() & 0x4u) != 0u)
+            {
+                const auto cursor = this->get_point();
+                if (!cursor.has_value())
+                {
+                    return this->reject();
+                }
+                frame.cursor = cursor.value();
+            }
+
+            frame.scroll = eqx::lib::Point<float>::origin();
+            if ((flags.value() & 0x8u) != 0u)
+            {
+                const auto scroll = this->get_point();
+                if (!scroll.has_value())
+                {
+                    return this->reject();
+                }
+                frame.scroll = scroll.value();
+            }
+
+            this->m_frame = frame;
+            return this->m_frame;
+        }
+
+        [[nodiscard]] inline bool done() const noexcept
+        {
+            return this->m_offset >= std::ranges::size(this->m_bytes);
+        }
+
+        // False once the file or any tick read so far was rejected.
+        [[nodiscard]] constexpr bool valid() const noexcept
+        {
+            return this->m_valid;
+        }
+
+        [[nodiscard]] constexpr float get_tick() const noexcept
+        {
+            return this->m_tick;
+        }
+
+    private:
+        [[nodiscard]] inline std::optional<Input_Frame> reject() noexcept
+        {
+            this->m_offset = std::ranges::size(this->m_bytes);
+            this->m_valid = false;
+            return std::nullopt;
+        }
+
+        template <typename T>
+        [[nodiscard]] inline std::optional<T> get() noexcept
+        {
+            if (std::ranges::size(this->m_bytes) - this->m_offset < sizeof(T))
+            {
+                return std::nullopt;
+            }
+
+            auto bytes = std::array<unsigned char, sizeof(T)>{};
+            std::ranges::copy_n(std::ranges::begin(this->m_bytes)
+                + static_cast<std::ptrdiff_t>(this->m_offset), sizeof(T),
+                std::ranges::begin(bytes));
+            this->m_offset += sizeof(T);
+
+            return std::bit_cast<T>(bytes);
+        }
+
+        [[nodiscard]] inline std::optional<eqx::lib::Point<float>>
+            get_point() noexcept
+        {
+            const auto x = this->get<float>();
+            const auto y = this->get<float>();
+            if (!x.has_value() || !y.has_value())
+            {
+                return std::nullopt;
+            }
+
+            return eqx::lib::Point<float>{ x.value(), y.value() };
+        }
+
+        std::vector<unsigned char> m_bytes;
+        std::size_t m_offset;
+        float m_tick;
+        Input_Frame m_frame;
+        bool m_valid;
+    };
+}
@@ -0,0 +1,182 @@
+// Sampler.cpp
+
+export module Eqx.OGL.Sampler;
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glad/glad.hpp>;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    static_assert(std::same_as<GLuint, unsigned int>);
+
+    struct Sampler_State
+    {
+        int min_filter;
+        int mag_filter;
+        int wrap_s;
+        int wrap_t;
+
+        [[nodiscard]] static constexpr Sampler_State linear() noexcept
+        {
+            return Sampler_State{ GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR,
+                GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE };
+        }
+
+        [[nodiscard]] static constexpr Sampler_State nearest() noexcept
+        {
+            return Sampler_State{ GL_NEAREST_MIPMAP_NEAREST, GL_NEAREST,
+                GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE };
+        }
+
+        [[nodiscard]] constexpr std::uint64_t key() const noexcept
+        {
+            return (static_cast<std::uint64_t>(this->min_filter) << 48)
+                | (static_cast<std::uint64_t>(this->mag_filter) << 32)
+                | (static_cast<std::uint64_t>(this->wrap_s) << 16)
+                | static_cast<std::uint64_t>(this->wrap_t);
+        }
+
+        constexpr bool operator== (const Sampler_State&) const = default;
+    };
+
+    class Sampler
+    {
+    public:
+        Sampler(const Sampler&) = delete;
+        Sampler& operator= (const Sampler&) = delete;
+
+        explicit constexpr Sampler() noexcept
+            :
+            m_id(0u)
+        {
+        }
+
+        explicit inline Sampler(const Sampler_State& state) noexcept
+            :
+            m_id(0u)
+        {
+            this->init(state);
+        }
+
+        constexpr Sampler(Sampler&& other) noexcept
+            :
+            m_id(std::exchange(other.m_id, 0u))
+        {
+        }
+
+        constexpr Sampler& operator= (Sampler&& other) noexcept
+        {
+            std::swap(this->m_id, other.m_id);
+            return *this;
+        }
+
+        constexpr ~Sampler() noexcept
+        {
+            if (this->valid()) [[likely]]
+            {
+                this->free();
+            }
+        }
+
+        inline void init(const Sampler_State& state) noexcept
+        {
+            assert(!this->valid());
+
+            glGenSamplers(1, &this->m_id);
+
+            assert(this->valid());
+
+            glSamplerParameteri(this->m_id, GL_TEXTURE_MIN_FILTER,
+                state.min_filter);
+            glSamplerParameteri(this->m_id, GL_TEXTURE_MAG_FILTER,
+                state.mag_filter);
+            glSamplerParameteri(this->m_id, GL_TEXTURE_WRAP_S, state.wrap_s);
+            glSamplerParameteri(this->m_id, GL_TEXTURE_WRAP_T, state.wrap_t);
+        }
+
+        inline void enable(const int i) const noexcept
+        {
+            assert(this->valid());
+
+            glBindSampler(static_cast<GLuint>(i), this->m_id);
+        }
+
+        inline void disable(const int i) const noexcept
+        {
+            assert(this->valid());
+
+            glBindSampler(static_cast<GLuint>(i), 0u);
+        }
+
+        [[nodiscard]] constexpr GLuint get_id() const noexcept
+        {
+            return this->m_id;
+        }
+
+        [[nodiscard]] constexpr bool valid() const noexcept
+        {
+            return this->m_id != 0u;
+        }
+
+        inline void free() noexcept
+        {
+            assert(this->valid());
+
+            glDeleteSamplers(1, &this->m_id);
+            this->m_id = 0u;
+
+            assert(!this->valid());
+        }
+
+    private:
+        GLuint m_id;
+    };
+
+    /*
+     * One Sampler per distinct Sampler_State. References stay valid until
+     * clear() or destruction, so callers may hold on to them.
+     */
+    class Sampler_Cache
+    {
+    public:
+        Sampler_Cache(const Sampler_Cache&) = delete;
+        Sampler_Cache& operator= (const Sampler_Cache&) = delete;
+        Sampler_Cache(Sampler_Cache&&) = default;
+        Sampler_Cache& operator= (Sampler_Cache&&) = default;
+        ~Sampler_Cache() = default;
+
+        explicit inline Sampler_Cache() noexcept
+            :
+            m_samplers()
+        {
+        }
+
+        [[nodiscard]] inline const Sampler& get(
+            const Sampler_State& state) noexcept
+        {
+            auto it = this->m_samplers.find(state.key());
+            if (it == std::ranges::end(this->m_samplers)) [[unlikely]]
+            {
+                it = this->m_samplers.emplace(state.key(),
+                    Sampler{ state }).first;
+            }
+
+            return it->second;
+        }
+
+        [[nodiscard]] inline std::size_t get_count() const noexcept
+        {
+            return std::ranges::size(this->m_samplers);
+        }
+
+        inline void clear() noexcept
+        {
+            this->m_samplers.clear();
+        }
+
+    private:
+        std::unordered_map<std::uint64_t, Sampler> m_samplers;
+    };
+}
@@ -1,6 +1,7 @@
 export module Eqx.OGL.Shader_Program;
 
 import Eqx.OGL.Shader_Source;
+import Eqx.OGL.Trace;
 
 import <Eqx/std.hpp>;
 import <Eqx/TPL/glad/glad.hpp>;
@@ -32,6 +33,14 @@ export namespace eqx::ogl
             this->init(vs, fs);
         }
 
+        explicit inline Shader_Program(const Vertex_Shader_Source& vs,
+            const std::span<const char* const> varyings) noexcept
+            :
+            m_id(0u)
+        {
+            this->init(vs, varyings);
+        }
+
         constexpr Shader_Program(Shader_Program&& other) noexcept
             :
             m_id(std::exchange(other.m_id, 0u))
@@ -63,11 +72,35 @@ export namespace eqx::ogl
             assert(vertex.valid());
             assert(fragment.valid());
 
+            const auto zone = Zone{ "Shader_Program::link"sv };
             glAttachShader(this->m_id, vertex.get_id());
             glAttachShader(this->m_id, fragment.get_id());
             glLinkProgram(this->m_id);
         }
 
+        /*
+         * Transform feedback program without a fragment stage, the vertex
+         * outputs named in varyings are captured interleaved in that order.
+         */
+        inline void init(const Vertex_Shader_Source& vertex,
+            const std::span<const char* const> varyings) noexcept
+        {
+            assert(!this->valid());
+
+            this->m_id = glCreateProgram();
+
+            assert(this->valid());
+            assert(vertex.valid());
+            assert(!std::ranges::empty(varyings));
+
+            const auto zone = Zone{ "Shader_Program::link"sv };
+            glAttachShader(this->m_id, vertex.get_id());
+            glTransformFeedbackVaryings(this->m_id,
+                static_cast<GLsizei>(std::ranges::size(varyings)),
+                varyings.data(), GL_INTERLEAVED_ATTRIBS);
+            glLinkProgram(this->m_id);
+        }
+
         inline void enable() const noexcept
         {
             assert(this->valid());
@@ -92,6 +125,36 @@ export namespace eqx::ogl
                 1, GL_FALSE, &mat[0][0]);
         }
 
+        inline void set_int(const std::string_view name,
+            const int value) const noexcept
+        {
+            assert(this->valid());
+
+            this->enable();
+            glUniform1i(glGetUniformLocation(this->m_id, name.data()), value);
+        }
+
+        inline void set_float(const std::string_view name,
+            const float value) const noexcept
+        {
+            assert(this->valid());
+
+            this->enable();
+            glUniform1f(glGetUniformLocation(this->m_id, name.data()), value);
+        }
+
+        // Sets name[0] onwards, the uniform must be a vec4 array.
+        inline void set_vec4s(const std::string_view name,
+            const std::span<const glm::vec4> values) const noexcept
+        {
+            assert(this->valid());
+
+            this->enable();
+            glUniform4fv(glGetUniformLocation(this->m_id, name.data()),
+                static_cast<GLsizei>(std::ranges::size(values)),
+                &values.front()[0]);
+        }
+
         inline void activate_texture(const std::string_view name,
             const int tex) const noexcept
         {
@@ -134,6 +197,14 @@ export namespace eqx::ogl
                 Fragment_Shader_Source::from_file(fsf) };
         }
 
+        [[nodiscard]] static inline Shader_Program from_feedback_file(
+            const std::filesystem::path& vsf,
+            const std::span<const char* const> varyings) noexcept
+        {
+            return Shader_Program{ Vertex_Shader_Source::from_file(vsf),
+                varyings };
+        }
+
     private:
         GLuint m_id;
     };
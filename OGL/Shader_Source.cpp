@@ -2,6 +2,8 @@
 
 export module Eqx.OGL.Shader_Source;
 
+import Eqx.OGL.Trace;
+
 import <Eqx/std.hpp>;
 import <Eqx/TPL/glad/glad.hpp>;
 
@@ -56,12 +58,18 @@ export namespace eqx::ogl
         {
             assert(!this->valid());
 
+            const auto zone = Zone{ "Shader_Source::compile"sv };
+
             this->m_id = glCreateShader(t_shader_type);
 
             assert(this->valid());
 
+            // Sources may be views into a mapped pack, which are not null
+            // terminated, so the length is always passed explicitly.
             auto source_data = source.data();
-            glShaderSource(this->m_id, 1, &source_data, nullptr);
+            const auto source_length =
+                static_cast<GLint>(std::ranges::size(source));
+            glShaderSource(this->m_id, 1, &source_data, &source_length);
             glCompileShader(this->m_id);
 
             assert(this->ok());
@@ -0,0 +1,265 @@
+// Spatial_Grid.cpp
+
+export module Eqx.OGL.Spatial_Grid;
+
+import <Eqx/std.hpp>;
+import Eqx.Lib;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    struct Aabb
+    {
+        float left;
+        float bottom;
+        float right;
+        float top;
+
+        [[nodiscard]] static constexpr Aabb from(
+            const eqx::lib::Polygon<float, 4>& polygon) noexcept
+        {
+            auto aabb = Aabb{ std::numeric_limits<float>::max(),
+                std::numeric_limits<float>::max(),
+                std::numeric_limits<float>::lowest(),
+                std::numeric_limits<float>::lowest() };
+
+            for (const auto& point : polygon.get_data())
+            {
+                aabb.left = std::min(aabb.left, point.get_x());
+                aabb.bottom = std::min(aabb.bottom, point.get_y());
+                aabb.right = std::max(aabb.right, point.get_x());
+                aabb.top = std::max(aabb.top, point.get_y());
+            }
+
+            return aabb;
+        }
+
+        [[nodiscard]] constexpr bool overlaps(const Aabb& other) const noexcept
+        {
+            return this->left <= other.right && other.left <= this->right
+                && this->bottom <= other.top && other.bottom <= this->top;
+        }
+    };
+
+    /*
+     * Uniform grid over 2D bounds for visibility queries.
+     *
+     * Objects are registered in every cell their bounds touch, cells live in
+     * a hash map so the grid is unbounded and only occupied cells cost
+     * memory. update() leaves the cells alone while an object stays within
+     * the same cell range, so slow movers cost a bounds copy per frame.
+     * query() stamps objects as it visits them so one touching many cells
+     * is reported once. Handles are reused after remove().
+     */
+    class Spatial_Grid
+    {
+    public:
+        using Handle = std::uint32_t;
+
+        Spatial_Grid(const Spatial_Grid&) = default;
+        Spatial_Grid(Spatial_Grid&&) = default;
+        Spatial_Grid& operator= (const Spatial_Grid&) = default;
+        Spatial_Grid& operator= (Spatial_Grid&&) = default;
+        ~Spatial_Grid() = default;
+
+        explicit inline Spatial_Grid(const float cell_size = 256.0F) noexcept
+            :
+            m_cell_size(cell_size),
+            m_cells(),
+            m_objects(),
+            m_free(),
+            m_stamp(0u),
+            m_visited(0ull)
+        {
+            assert(cell_size > 0.0F);
+        }
+
+        [[nodiscard]] inline Handle insert(const Aabb& bounds) noexcept
+        {
+            auto handle = static_cast<Handle>(std::ranges::size(
+                this->m_objects));
+            if (std::ranges::empty(this->m_free))
+            {
+                this->m_objects.emplace_back();
+            }
+            else
+            {
+                handle = this->m_free.back();
+                this->m_free.pop_back();
+            }
+
+            auto& object = this->m_objects[handle];
+            object.bounds = bounds;
+            object.range = this->to_range(bounds);
+            object.stamp = this->m_stamp;
+            object.live = true;
+            this->link(handle, object.range);
+
+            return handle;
+        }
+
+        inline void update(const Handle handle, const Aabb& bounds) noexcept
+        {
+            assert(this->contains(handle));
+
+            auto& object = this->m_objects[handle];
+            object.bounds = bounds;
+
+            const auto range = this->to_range(bounds);
+            if (range != object.range)
+            {
+                this->unlink(handle, object.range);
+                object.range = range;
+                this->link(handle, range);
+            }
+        }
+
+        inline void remove(const Handle handle) noexcept
+        {
+            assert(this->contains(handle));
+
+            auto& object = this->m_objects[handle];
+            this->unlink(handle, object.range);
+            object.live = false;
+            this->m_free.push_back(handle);
+        }
+
+        // Appends to result, which the caller clears between frames.
+        inline void query(const Aabb& area,
+            std::vector<Handle>& result) noexcept
+        {
+            ++this->m_stamp;
+
+            const auto range = this->to_range(area);
+            for (auto y = range.y0; y <= range.y1; ++y)
+            {
+                for (auto x = range.x0; x <= range.x1; ++x)
+                {
+                    const auto it = this->m_cells.find(Spatial_Grid::key(x, y));
+                    if (it == std::ranges::end(this->m_cells))
+                    {
+                        continue;
+                    }
+
+                    for (const auto handle : it->second)
+                    {
+                        auto& object = this->m_objects[handle];
+                        ++this->m_visited;
+                        if (object.stamp == this->m_stamp)
+                        {
+                            continue;
+                        }
+
+                        object.stamp = this->m_stamp;
+                        if (object.bounds.overlaps(area))
+                        {
+                            result.push_back(handle);
+                        }
+                    }
+                }
+            }
+        }
+
+        [[nodiscard]] constexpr bool contains(
+            const Handle handle) const noexcept
+        {
+            return handle < std::ranges::size(this->m_objects)
+                && this->m_objects[handle].live;
+        }
+
+        [[nodiscard]] constexpr std::size_t get_size() const noexcept
+        {
+            return std::ranges::size(this->m_objects)
+                - std::ranges::size(this->m_free);
+        }
+
+        [[nodiscard]] inline std::size_t get_cell_count() const noexcept
+        {
+            return std::ranges::size(this->m_cells);
+        }
+
+        // Cell entries examined by every query so far.
+        [[nodiscard]] constexpr unsigned long long
+            get_visited() const noexcept
+        {
+            return this->m_visited;
+        }
+
+    private:
+        struct Range
+        {
+            int x0;
+            int y0;
+            int x1;
+            int y1;
+
+            constexpr bool operator== (const Range&) const = default;
+        };
+
+        struct Object
+        {
+            Aabb bounds;
+            Range range;
+            std::uint32_t stamp;
+            bool live;
+        };
+
+        [[nodiscard]] static constexpr std::uint64_t key(const int x,
+            const int y) noexcept
+        {
+            return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x))
+                << 32) | static_cast<std::uint64_t>(
+                    static_cast<std::uint32_t>(y));
+        }
+
+        [[nodiscard]] inline Range to_range(const Aabb& bounds) const noexcept
+        {
+            const auto cell = [this](const float v) noexcept
+            {
+                return static_cast<int>(std::floor(v / this->m_cell_size));
+            };
+
+            return Range{ cell(bounds.left), cell(bounds.bottom),
+                cell(bounds.right), cell(bounds.top) };
+        }
+
+        inline void link(const Handle handle, const Range& range) noexcept
+        {
+            for (auto y = range.y0; y <= range.y1; ++y)
+            {
+                for (auto x = range.x0; x <= range.x1; ++x)
+                {
+                    this->m_cells[Spatial_Grid::key(x, y)].push_back(handle);
+                }
+            }
+        }
+
+        inline void unlink(const Handle handle, const Range& range) noexcept
+        {
+            for (auto y = range.y0; y <= range.y1; ++y)
+            {
+                for (auto x = range.x0; x <= range.x1; ++x)
+                {
+                    const auto it = this->m_cells.find(
+                        Spatial_Grid::key(x, y));
+                    assert(it != std::ranges::end(this->m_cells));
+
+                    auto& cell = it->second;
+                    std::erase(cell, handle);
+                    if (std::ranges::empty(cell))
+                    {
+                        this->m_cells.erase(it);
+                    }
+                }
+            }
+        }
+
+        float m_cell_size;
+        std::unordered_map<std::uint64_t, std::vector<Handle>> m_cells;
+        std::vector<Object> m_objects;
+        std::vector<Handle> m_free;
+        std::uint32_t m_stamp;
+        unsigned long long m_visited;
+    };
+}
@@ -0,0 +1,251 @@
+// Sprite_Batch.cpp
+
+export module Eqx.OGL.Sprite_Batch;
+
+import Eqx.OGL.Buffer;
+import Eqx.OGL.Gpu_Memory;
+import Eqx.OGL.Sampler;
+import Eqx.OGL.Texture;
+import Eqx.OGL.Trace;
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glad/glad.hpp>;
+import Eqx.Lib;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    static_assert(std::same_as<GLuint, unsigned int>);
+
+    struct Uv_Rect
+    {
+        float u0;
+        float v0;
+        float u1;
+        float v1;
+
+        [[nodiscard]] static constexpr Uv_Rect full() noexcept
+        {
+            return Uv_Rect{ 0.0F, 0.0F, 1.0F, 1.0F };
+        }
+    };
+
+    /*
+     * Collects textured quads into a CPU staging array and draws them with
+     * as few calls as possible.
+     *
+     * Consecutive submissions sharing a texture and sampler form one batch.
+     * flush() streams the whole staging array into an orphaned vertex
+     * buffer with a single upload and issues one draw per batch, the index
+     * buffer is a static quad list built once. The staging array flushes
+     * itself when it reaches capacity. Vertices are (x, y, u, v) at
+     * attribute locations 0 and 1, the caller enables the shader program.
+     */
+    class Sprite_Batch
+    {
+    public:
+        Sprite_Batch(const Sprite_Batch&) = delete;
+        Sprite_Batch(Sprite_Batch&&) = delete;
+        Sprite_Batch& operator= (const Sprite_Batch&) = delete;
+        Sprite_Batch& operator= (Sprite_Batch&&) = delete;
+
+        explicit inline Sprite_Batch(
+            const std::size_t capacity = 4'096ull) noexcept
+            :
+            m_capacity(capacity),
+            m_vertex_array(0u),
+            m_vertex_buffer(0u),
+            m_index_buffer(),
+            m_vertices(),
+            m_batches(),
+            m_sprites(0ull),
+            m_draws(0ull),
+            m_flushes(0ull)
+        {
+            assert(capacity > 0ull);
+            assert(capacity * 4ull
+                <= std::numeric_limits<unsigned int>::max());
+
+            this->m_vertices.reserve(capacity * c_floats_per_sprite);
+
+            glGenVertexArrays(1, &this->m_vertex_array);
+            glGenBuffers(1, &this->m_vertex_buffer);
+            this->m_index_buffer.init();
+
+            glBindVertexArray(this->m_vertex_array);
+            glBindBuffer(GL_ARRAY_BUFFER, this->m_vertex_buffer);
+            glBufferData(GL_ARRAY_BUFFER, this->get_buffer_bytes(), nullptr,
+                GL_STREAM_DRAW);
+            Gpu_Memory::track(Gpu_Memory::Category::Vertex_Buffer,
+                this->m_vertex_buffer, this->get_buffer_bytes());
+
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE,
+                4 * sizeof(float), (void*)0);
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE,
+                4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+            auto indices = std::vector<unsigned int>(capacity * 6ull);
+            for (auto i = 0ull; i < capacity; ++i)
+            {
+                const auto v = static_cast<unsigned int>(i * 4ull);
+                std::ranges::copy(std::array<unsigned int, 6>{
+                    v, v + 1u, v + 3u, v + 1u, v + 2u, v + 3u },
+                    std::ranges::begin(indices)
+                        + static_cast<std::ptrdiff_t>(i * 6ull));
+            }
+            this->m_index_buffer.buffer_data(indices);
+
+            glBindVertexArray(0u);
+        }
+
+        inline ~Sprite_Batch() noexcept
+        {
+            Gpu_Memory::untrack(Gpu_Memory::Category::Vertex_Buffer,
+                this->m_vertex_buffer);
+            glDeleteBuffers(1, &this->m_vertex_buffer);
+            glDeleteVertexArrays(1, &this->m_vertex_array);
+        }
+
+        /*
+         * Corners follow eqx::lib::Polygon's winding, corner 1 takes
+         * (u0, v0) and corner 3 (u1, v1).
+         */
+        inline void submit(const eqx::lib::Polygon<float, 4>& quad,
+            const Texture& texture, const Sampler& sampler,
+            const Uv_Rect& uv = Uv_Rect::full()) noexcept
+        {
+            assert(texture.valid());
+            assert(sampler.valid());
+
+            if (this->get_pending() == this->m_capacity) [[unlikely]]
+            {
+                this->flush();
+            }
+
+            if (std::ranges::empty(this->m_batches)
+                || this->m_batches.back().texture != &texture
+                || this->m_batches.back().sampler != &sampler)
+            {
+                this->m_batches.push_back(Batch{ &texture, &sampler,
+                    this->get_pending(), 0ull });
+            }
+            ++this->m_batches.back().count;
+
+            const auto& p = quad.get_data();
+            const auto corners = std::array<float, c_floats_per_sprite>{
+                p[0].get_x(), p[0].get_y(), uv.u1, uv.v0,
+                p[1].get_x(), p[1].get_y(), uv.u0, uv.v0,
+                p[2].get_x(), p[2].get_y(), uv.u0, uv.v1,
+                p[3].get_x(), p[3].get_y(), uv.u1, uv.v1 };
+            this->m_vertices.insert(std::ranges::end(this->m_vertices),
+                std::ranges::begin(corners), std::ranges::end(corners));
+            ++this->m_sprites;
+        }
+
+        inline void flush() noexcept
+        {
+            if (std::ranges::empty(this->m_batches))
+            {
+                return;
+            }
+
+            const auto zone = Zone{ "Sprite_Batch::flush"sv };
+            glBindVertexArray(this->m_vertex_array);
+            glBindBuffer(GL_ARRAY_BUFFER, this->m_vertex_buffer);
+
+            // Orphaning hands the driver a fresh store so the upload never
+            // waits on draws still reading the previous one.
+            glBufferData(GL_ARRAY_BUFFER, this->get_buffer_bytes(), nullptr,
+                GL_STREAM_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0,
+                static_cast<GLsizeiptr>(
+                    std::ranges::size(this->m_vertices) * sizeof(float)),
+                this->m_vertices.data());
+
+            for (const auto& batch : this->m_batches)
+            {
+                batch.texture->enable(0, *batch.sampler);
+                glDrawElements(GL_TRIANGLES,
+                    static_cast<GLsizei>(batch.count * 6ull),
+                    GL_UNSIGNED_INT,
+                    (void*)(batch.first * 6ull * sizeof(unsigned int)));
+            }
+
+            this->m_draws += std::ranges::size(this->m_batches);
+            ++this->m_flushes;
+            this->m_vertices.clear();
+            this->m_batches.clear();
+        }
+
+        inline void reset_stats() noexcept
+        {
+            this->m_sprites = 0ull;
+            this->m_draws = 0ull;
+            this->m_flushes = 0ull;
+        }
+
+        [[nodiscard]] constexpr std::size_t get_capacity() const noexcept
+        {
+            return this->m_capacity;
+        }
+
+        [[nodiscard]] constexpr std::size_t get_pending() const noexcept
+        {
+            return std::ranges::size(this->m_vertices) / c_floats_per_sprite;
+        }
+
+        // The pending sprites' corners as submit() laid them out.
+        [[nodiscard]] inline std::span<const float>
+            get_vertices() const noexcept
+        {
+            return this->m_vertices;
+        }
+
+        [[nodiscard]] constexpr unsigned long long
+            get_sprites() const noexcept
+        {
+            return this->m_sprites;
+        }
+
+        // Draw calls issued, one per batch.
+        [[nodiscard]] constexpr unsigned long long get_draws() const noexcept
+        {
+            return this->m_draws;
+        }
+
+        [[nodiscard]] constexpr unsigned long long
+            get_flushes() const noexcept
+        {
+            return this->m_flushes;
+        }
+
+    private:
+        struct Batch
+        {
+            const Texture* texture;
+            const Sampler* sampler;
+            std::size_t first;
+            std::size_t count;
+        };
+
+        static constexpr auto c_floats_per_sprite = 16ull;
+
+        [[nodiscard]] constexpr std::size_t get_buffer_bytes() const noexcept
+        {
+            return this->m_capacity * c_floats_per_sprite * sizeof(float);
+        }
+
+        std::size_t m_capacity;
+        GLuint m_vertex_array;
+        GLuint m_vertex_buffer;
+        Index_Buffer m_index_buffer;
+        std::vector<float> m_vertices;
+        std::vector<Batch> m_batches;
+        unsigned long long m_sprites;
+        unsigned long long m_draws;
+        unsigned long long m_flushes;
+    };
+}
@@ -0,0 +1,409 @@
+// Sprite_Builder.cpp
+
+export module Eqx.OGL.Sprite_Builder;
+
+import Eqx.OGL.Buffer;
+import Eqx.OGL.Gpu_Memory;
+import Eqx.OGL.Sampler;
+import Eqx.OGL.Sprite_Batch;
+import Eqx.OGL.Sprite_Instancer;
+import Eqx.OGL.Texture;
+import Eqx.OGL.Trace;
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glad/glad.hpp>;
+import Eqx.Lib;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    static_assert(std::same_as<GLuint, unsigned int>);
+
+    /*
+     * Sprite_Batch whose vertices are built on several threads.
+     *
+     * submit() only records spans of Sprites, which must stay alive until
+     * the next flush(). flush() maps the stream buffer once and splits the
+     * pending sprites into contiguous partitions, the calling thread and
+     * each worker rotate and expand their partition's corners straight into
+     * a disjoint slice of the mapping. Once all are done the calling thread
+     * unmaps and issues one draw per run of equal texture and sampler, so GL
+     * is only ever called from it. Vertices match Sprite_Batch's, a
+     * Sprite's layer and tint are not part of them. Small flushes are not
+     * worth waking the workers for and are built on the calling thread.
+     */
+    class Sprite_Builder
+    {
+    public:
+        static constexpr auto c_min_partition = std::size_t{ 1'024 };
+
+        Sprite_Builder(const Sprite_Builder&) = delete;
+        Sprite_Builder(Sprite_Builder&&) = delete;
+        Sprite_Builder& operator= (const Sprite_Builder&) = delete;
+        Sprite_Builder& operator= (Sprite_Builder&&) = delete;
+
+        explicit inline Sprite_Builder(
+            const std::size_t capacity = 65'536ull,
+            const std::size_t workers = Sprite_Builder::default_workers())
+            noexcept
+            :
+            m_capacity(capacity),
+            m_vertex_array(0u),
+            m_vertex_buffer(0u),
+            m_index_buffer(),
+            m_runs(),
+            m_pending(0ull),
+            m_target(nullptr),
+            m_parts(1ull),
+            m_mutex(),
+            m_start(),
+            m_finish(),
+            m_generation(0ull),
+            m_remaining(0ull),
+            m_sprites(0ull),
+            m_draws(0ull),
+            m_flushes(0ull),
+            m_workers()
+        {
+            assert(capacity > 0ull);
+            assert(capacity * 4ull
+                <= std::numeric_limits<unsigned int>::max());
+
+            glGenVertexArrays(1, &this->m_vertex_array);
+            glGenBuffers(1, &this->m_vertex_buffer);
+            this->m_index_buffer.init();
+
+            glBindVertexArray(this->m_vertex_array);
+            glBindBuffer(GL_ARRAY_BUFFER, this->m_vertex_buffer);
+            glBufferData(GL_ARRAY_BUFFER, this->get_buffer_bytes(), nullptr,
+                GL_STREAM_DRAW);
+            Gpu_Memory::track(Gpu_Memory::Category::Vertex_Buffer,
+                this->m_vertex_buffer, this->get_buffer_bytes());
+
+            glEnableVertexAttribArray(0);
+            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE,
+                4 * sizeof(float), (void*)0);
+            glEnableVertexAttribArray(1);
+            glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE,
+                4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+            auto indices = std::vector<unsigned int>(capacity * 6ull);
+            for (auto i = 0ull; i < capacity; ++i)
+            {
+                const auto v = static_cast<unsigned int>(i * 4ull);
+                std::ranges::copy(std::array<unsigned int, 6>{
+                    v, v + 1u, v + 3u, v + 1u, v + 2u, v + 3u },
+                    std::ranges::begin(indices)
+                        + static_cast<std::ptrdiff_t>(i * 6ull));
+            }
+            this->m_index_buffer.buffer_data(indices);
+
+            glBindVertexArray(0u);
+
+            this->m_workers.reserve(workers);
+            for (auto i = 0ull; i < workers; ++i)
+            {
+                this->m_workers.emplace_back(
+                    [this, i](std::stop_token token) noexcept
+                    {
+                        this->work(token, i + 1ull);
+                    });
+            }
+        }
+
+        // The workers are stopped and joined by their jthreads.
+        inline ~Sprite_Builder() noexcept
+        {
+            Gpu_Memory::untrack(Gpu_Memory::Category::Vertex_Buffer,
+                this->m_vertex_buffer);
+            glDeleteBuffers(1, &this->m_vertex_buffer);
+            glDeleteVertexArrays(1, &this->m_vertex_array);
+        }
+
+        inline void submit(std::span<const Sprite> sprites,
+            const Texture& texture, const Sampler& sampler) noexcept
+        {
+            assert(texture.valid());
+            assert(sampler.valid());
+
+            while (!std::ranges::empty(sprites))
+            {
+                if (this->m_pending == this->m_capacity) [[unlikely]]
+                {
+                    this->flush();
+                }
+
+                const auto count = std::min(std::ranges::size(sprites),
+                    this->m_capacity - this->m_pending);
+                this->m_runs.push_back(Run{ sprites.first(count), &texture,
+                    &sampler, this->m_pending });
+                this->m_pending += count;
+                this->m_sprites += count;
+                sprites = sprites.subspan(count);
+            }
+        }
+
+        inline void flush() noexcept
+        {
+            if (std::ranges::empty(this->m_runs))
+            {
+                return;
+            }
+
+            const auto zone = Zone{ "Sprite_Builder::flush"sv };
+            glBindVertexArray(this->m_vertex_array);
+            glBindBuffer(GL_ARRAY_BUFFER, this->m_vertex_buffer);
+
+            // Invalidating orphans the store like Sprite_Batch's
+            // glBufferData, so mapping never waits on earlier draws.
+            this->m_target = static_cast<float*>(glMapBufferRange(
+                GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(
+                    this->m_pending * c_floats_per_sprite * sizeof(float)),
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT));
+            assert(this->m_target != nullptr);
+
+            {
+                const auto lock = std::scoped_lock{ this->m_mutex };
+                this->m_parts = std::clamp(this->m_pending / c_min_partition,
+                    std::size_t{ 1 }, std::ranges::size(this->m_workers) + 1);
+                if (this->m_parts > 1ull)
+                {
+                    ++this->m_generation;
+                    this->m_remaining = this->m_parts - 1ull;
+                }
+            }
+            if (this->m_parts > 1ull)
+            {
+                this->m_start.notify_all();
+            }
+
+            this->build(0ull);
+
+            if (this->m_parts > 1ull)
+            {
+                const auto zone = Zone{ "Sprite_Builder::wait"sv };
+                auto lock = std::unique_lock{ this->m_mutex };
+                this->m_finish.wait(lock, [this]() noexcept
+                    {
+                        return this->m_remaining == 0ull;
+                    });
+            }
+
+            [[maybe_unused]] const auto intact =
+                glUnmapBuffer(GL_ARRAY_BUFFER);
+            assert(intact == GL_TRUE);
+            this->m_target = nullptr;
+
+            auto first = std::ranges::begin(this->m_runs);
+            while (first != std::ranges::end(this->m_runs))
+            {
+                const auto last = std::ranges::find_if(first,
+                    std::ranges::end(this->m_runs), [&first](const Run& run)
+                    {
+                        return run.texture != first->texture
+                            || run.sampler != first->sampler;
+                    });
+                const auto count = std::prev(last)->first
+                    + std::ranges::size(std::prev(last)->sprites)
+                    - first->first;
+
+                first->texture->enable(0, *first->sampler);
+                glDrawElements(GL_TRIANGLES,
+                    static_cast<GLsizei>(count * 6ull), GL_UNSIGNED_INT,
+                    (void*)(first->first * 6ull * sizeof(unsigned int)));
+                ++this->m_draws;
+                first = last;
+            }
+
+            ++this->m_flushes;
+            this->m_runs.clear();
+            this->m_pending = 0ull;
+        }
+
+        inline void reset_stats() noexcept
+        {
+            this->m_sprites = 0ull;
+            this->m_draws = 0ull;
+            this->m_flushes = 0ull;
+        }
+
+        [[nodiscard]] static inline std::size_t default_workers() noexcept
+        {
+            const auto cores = std::thread::hardware_concurrency();
+            return cores > 1u ? static_cast<std::size_t>(cores - 1u) : 0ull;
+        }
+
+        [[nodiscard]] constexpr std::size_t get_capacity() const noexcept
+        {
+            return this->m_capacity;
+        }
+
+        [[nodiscard]] constexpr std::size_t get_pending() const noexcept
+        {
+            return this->m_pending;
+        }
+
+        [[nodiscard]] inline std::size_t get_workers() const noexcept
+        {
+            return std::ranges::size(this->m_workers);
+        }
+
+        // Holds the last flush()'s vertices, first sprite first.
+        [[nodiscard]] constexpr GLuint get_vertex_buffer() const noexcept
+        {
+            return this->m_vertex_buffer;
+        }
+
+        // Threads that built the last flush(), the calling one included.
+        [[nodiscard]] constexpr std::size_t get_parts() const noexcept
+        {
+            return this->m_parts;
+        }
+
+        [[nodiscard]] constexpr unsigned long long
+            get_sprites() const noexcept
+        {
+            return this->m_sprites;
+        }
+
+        // Draw calls issued, one per run of equal texture and sampler.
+        [[nodiscard]] constexpr unsigned long long get_draws() const noexcept
+        {
+            return this->m_draws;
+        }
+
+        [[nodiscard]] constexpr unsigned long long
+            get_flushes() const noexcept
+        {
+            return this->m_flushes;
+        }
+
+    private:
+        struct Run
+        {
+            std::span<const Sprite> sprites;
+            const Texture* texture;
+            const Sampler* sampler;
+            std::size_t first;
+        };
+
+        static constexpr auto c_floats_per_sprite = 16ull;
+
+        [[nodiscard]] constexpr std::size_t get_buffer_bytes() const noexcept
+        {
+            return this->m_capacity * c_floats_per_sprite * sizeof(float);
+        }
+
+        inline void work(const std::stop_token& token,
+            const std::size_t part) noexcept
+        {
+            Trace::set_thread_name(std::format("Sprite_Builder {}"sv, part));
+
+            auto seen = 0ull;
+            while (true)
+            {
+                auto active = false;
+                {
+                    auto lock = std::unique_lock{ this->m_mutex };
+                    if (!this->m_start.wait(lock, token, [this, &seen]()
+                        noexcept
+                        {
+                            return this->m_generation != seen;
+                        }))
+                    {
+                        break;
+                    }
+                    seen = this->m_generation;
+                    active = part < this->m_parts;
+                }
+
+                if (!active)
+                {
+                    continue;
+                }
+
+                this->build(part);
+
+                auto notify = false;
+                {
+                    const auto lock = std::scoped_lock{ this->m_mutex };
+                    notify = --this->m_remaining == 0ull;
+                }
+                if (notify)
+                {
+                    this->m_finish.notify_one();
+                }
+            }
+        }
+
+        // Reads only state written before the generation was bumped.
+        inline void build(const std::size_t part) const noexcept
+        {
+            const auto zone = Zone{ "Sprite_Builder::build"sv };
+            const auto begin = this->m_pending * part / this->m_parts;
+            const auto end = this->m_pending * (part + 1ull) / this->m_parts;
+            if (begin == end)
+            {
+                return;
+            }
+
+            auto run = std::ranges::prev(std::ranges::upper_bound(
+                this->m_runs, begin, {}, &Run::first));
+            for (auto i = begin; i < end; ++i)
+            {
+                while (i >= run->first + std::ranges::size(run->sprites))
+                {
+                    ++run;
+                }
+
+                Sprite_Builder::expand(run->sprites[i - run->first],
+                    this->m_target + i * c_floats_per_sprite);
+            }
+        }
+
+        // Same corners and rotation as the Sprite vertex shader.
+        static inline void expand(const Sprite& sprite, float* out) noexcept
+        {
+            const auto c = std::cos(sprite.rotation);
+            const auto s = std::sin(sprite.rotation);
+            const auto hx = sprite.half_extents.get_x();
+            const auto hy = sprite.half_extents.get_y();
+            const auto x = sprite.position.get_x();
+            const auto y = sprite.position.get_y();
+            const auto& uv = sprite.uv;
+
+            const auto corner = [&](const float lx, const float ly,
+                const float u, const float v, float* vertex) noexcept
+            {
+                vertex[0] = x + lx * c - ly * s;
+                vertex[1] = y + lx * s + ly * c;
+                vertex[2] = u;
+                vertex[3] = v;
+            };
+
+            corner(hx, hy, uv.u1, uv.v0, out);
+            corner(-hx, hy, uv.u0, uv.v0, out + 4);
+            corner(-hx, -hy, uv.u0, uv.v1, out + 8);
+            corner(hx, -hy, uv.u1, uv.v1, out + 12);
+        }
+
+        std::size_t m_capacity;
+        GLuint m_vertex_array;
+        GLuint m_vertex_buffer;
+        Index_Buffer m_index_buffer;
+        std::vector<Run> m_runs;
+        std::size_t m_pending;
+        float* m_target;
+        std::size_t m_parts;
+        std::mutex m_mutex;
+        std::condition_variable_any m_start;
+        std::condition_variable m_finish;
+        unsigned long long m_generation;
+        std::size_t m_remaining;
+        unsigned long long m_sprites;
+        unsigned long long m_draws;
+        unsigned long long m_flushes;
+        std::vector<std::jthread> m_workers;
+    };
+}
@@ -0,0 +1,308 @@
+// Sprite_Instancer.cpp
+
+export module Eqx.OGL.Sprite_Instancer;
+
+import Eqx.OGL.Gpu_Memory;
+import Eqx.OGL.Sampler;
+import Eqx.OGL.Sprite_Batch;
+import Eqx.OGL.Texture;
+import Eqx.OGL.Trace;
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glad/glad.hpp>;
+import Eqx.Lib;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    static_assert(std::same_as<GLuint, unsigned int>);
+
+    struct Sprite
+    {
+        eqx::lib::Point<float> position;
+        eqx::lib::Point<float> half_extents;
+        float rotation = 0.0F;
+        Uv_Rect uv = Uv_Rect::full();
+        std::uint16_t layer = 0u;
+        std::array<std::uint8_t, 4> tint =
+            std::array<std::uint8_t, 4>{ 255u, 255u, 255u, 255u };
+    };
+
+    /*
+     * Instanced counterpart of Sprite_Batch.
+     *
+     * Each sprite is packed into one 28 byte record, against the 64 bytes
+     * of four expanded corners: position as floats, half extents as half
+     * floats, rotation in turns, layer and UV rect as normalized shorts and
+     * an RGBA8 tint. The vertex shader in Resources/Shaders/Sprite rotates
+     * and expands the corners from gl_VertexID, so the CPU does no trig.
+     * Batches break on texture or sampler change as in Sprite_Batch, each
+     * one is a single instanced triangle strip. Layer 0 is furthest back
+     * when depth testing is on, every layer maps strictly inside the depth
+     * range, so the default GL_LESS against a buffer cleared to 1.0 works.
+     */
+    class Sprite_Instancer
+    {
+    public:
+        Sprite_Instancer(const Sprite_Instancer&) = delete;
+        Sprite_Instancer(Sprite_Instancer&&) = delete;
+        Sprite_Instancer& operator= (const Sprite_Instancer&) = delete;
+        Sprite_Instancer& operator= (Sprite_Instancer&&) = delete;
+
+        explicit inline Sprite_Instancer(
+            const std::size_t capacity = 16'384ull) noexcept
+            :
+            m_capacity(capacity),
+            m_vertex_array(0u),
+            m_instance_buffer(0u),
+            m_records(),
+            m_batches(),
+            m_sprites(0ull),
+            m_draws(0ull),
+            m_flushes(0ull)
+        {
+            assert(capacity > 0ull);
+
+            this->m_records.reserve(capacity);
+
+            glGenVertexArrays(1, &this->m_vertex_array);
+            glGenBuffers(1, &this->m_instance_buffer);
+
+            glBindVertexArray(this->m_vertex_array);
+            glBindBuffer(GL_ARRAY_BUFFER, this->m_instance_buffer);
+            glBufferData(GL_ARRAY_BUFFER, this->get_buffer_bytes(), nullptr,
+                GL_STREAM_DRAW);
+            Gpu_Memory::track(Gpu_Memory::Category::Vertex_Buffer,
+                this->m_instance_buffer, this->get_buffer_bytes());
+
+            for (auto i = 0u; i < 5u; ++i)
+            {
+                glEnableVertexAttribArray(i);
+                glVertexAttribDivisor(i, 1u);
+            }
+            Sprite_Instancer::set_attributes(0ull);
+
+            glBindVertexArray(0u);
+        }
+
+        inline ~Sprite_Instancer() noexcept
+        {
+            Gpu_Memory::untrack(Gpu_Memory::Category::Vertex_Buffer,
+                this->m_instance_buffer);
+            glDeleteBuffers(1, &this->m_instance_buffer);
+            glDeleteVertexArrays(1, &this->m_vertex_array);
+        }
+
+        inline void submit(const Sprite& sprite, const Texture& texture,
+            const Sampler& sampler) noexcept
+        {
+            assert(texture.valid());
+            assert(sampler.valid());
+
+            if (std::ranges::size(this->m_records) == this->m_capacity)
+                [[unlikely]]
+            {
+                this->flush();
+            }
+
+            if (std::ranges::empty(this->m_batches)
+                || this->m_batches.back().texture != &texture
+                || this->m_batches.back().sampler != &sampler)
+            {
+                this->m_batches.push_back(Batch{ &texture, &sampler,
+                    std::ranges::size(this->m_records), 0ull });
+            }
+            ++this->m_batches.back().count;
+
+            this->m_records.push_back(Sprite_Instancer::pack(sprite));
+            ++this->m_sprites;
+        }
+
+        inline void flush() noexcept
+        {
+            if (std::ranges::empty(this->m_batches))
+            {
+                return;
+            }
+
+            const auto zone = Zone{ "Sprite_Instancer::flush"sv };
+            glBindVertexArray(this->m_vertex_array);
+            glBindBuffer(GL_ARRAY_BUFFER, this->m_instance_buffer);
+
+            glBufferData(GL_ARRAY_BUFFER, this->get_buffer_bytes(), nullptr,
+                GL_STREAM_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0,
+                static_cast<GLsizeiptr>(
+                    std::ranges::size(this->m_records) * sizeof(Record)),
+                this->m_records.data());
+
+            // Without base instance (GL 4.2) each batch re-points the
+            // attributes at its first record instead.
+            for (const auto& batch : this->m_batches)
+            {
+                batch.texture->enable(0, *batch.sampler);
+                Sprite_Instancer::set_attributes(batch.first);
+                glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4,
+                    static_cast<GLsizei>(batch.count));
+            }
+
+            this->m_draws += std::ranges::size(this->m_batches);
+            ++this->m_flushes;
+            this->m_records.clear();
+            this->m_batches.clear();
+        }
+
+        inline void reset_stats() noexcept
+        {
+            this->m_sprites = 0ull;
+            this->m_draws = 0ull;
+            this->m_flushes = 0ull;
+        }
+
+        [[nodiscard]] constexpr std::size_t get_capacity() const noexcept
+        {
+            return this->m_capacity;
+        }
+
+        [[nodiscard]] constexpr std::size_t get_pending() const noexcept
+        {
+            return std::ranges::size(this->m_records);
+        }
+
+        [[nodiscard]] constexpr unsigned long long
+            get_sprites() const noexcept
+        {
+            return this->m_sprites;
+        }
+
+        [[nodiscard]] constexpr unsigned long long get_draws() const noexcept
+        {
+            return this->m_draws;
+        }
+
+        [[nodiscard]] constexpr unsigned long long
+            get_flushes() const noexcept
+        {
+            return this->m_flushes;
+        }
+
+        [[nodiscard]] static consteval std::size_t
+            get_record_bytes() noexcept
+        {
+            return sizeof(Record);
+        }
+
+    private:
+        struct Record
+        {
+            std::array<float, 2> position;
+            std::array<std::uint16_t, 2> half_extents;
+            std::uint16_t rotation;
+            std::uint16_t layer;
+            std::array<std::uint16_t, 4> uv;
+            std::array<std::uint8_t, 4> tint;
+        };
+        static_assert(sizeof(Record) == 28ull);
+
+        struct Batch
+        {
+            const Texture* texture;
+            const Sampler* sampler;
+            std::size_t first;
+            std::size_t count;
+        };
+
+        static inline void set_attributes(const std::size_t first) noexcept
+        {
+            const auto base = first * sizeof(Record);
+            const auto attribute = [base](const GLuint index, const GLint size,
+                const GLenum type, const GLboolean normalized,
+                const std::size_t offset) noexcept
+            {
+                glVertexAttribPointer(index, size, type, normalized,
+                    sizeof(Record), (void*)(base + offset));
+            };
+
+            // Rotation and layer share location 2.
+            attribute(0u, 2, GL_FLOAT, GL_FALSE, 0ull);
+            attribute(1u, 2, GL_HALF_FLOAT, GL_FALSE, 8ull);
+            attribute(2u, 2, GL_UNSIGNED_SHORT, GL_TRUE, 12ull);
+            attribute(3u, 4, GL_UNSIGNED_SHORT, GL_TRUE, 16ull);
+            attribute(4u, 4, GL_UNSIGNED_BYTE, GL_TRUE, 24ull);
+        }
+
+        [[nodiscard]] static inline Record pack(const Sprite& sprite) noexcept
+        {
+            constexpr auto tau = 2.0F * std::numbers::pi_v<float>;
+
+            auto turns = std::fmod(sprite.rotation / tau, 1.0F);
+            if (turns < 0.0F)
+            {
+                turns += 1.0F;
+            }
+
+            return Record{
+                std::array<float, 2>{
+                    sprite.position.get_x(), sprite.position.get_y() },
+                std::array<std::uint16_t, 2>{
+                    Sprite_Instancer::to_half(sprite.half_extents.get_x()),
+                    Sprite_Instancer::to_half(sprite.half_extents.get_y()) },
+                Sprite_Instancer::to_unorm(turns),
+                sprite.layer,
+                std::array<std::uint16_t, 4>{
+                    Sprite_Instancer::to_unorm(sprite.uv.u0),
+                    Sprite_Instancer::to_unorm(sprite.uv.v0),
+                    Sprite_Instancer::to_unorm(sprite.uv.u1),
+                    Sprite_Instancer::to_unorm(sprite.uv.v1) },
+                sprite.tint };
+        }
+
+        [[nodiscard]] static constexpr std::uint16_t to_unorm(
+            const float value) noexcept
+        {
+            return static_cast<std::uint16_t>(
+                std::clamp(value, 0.0F, 1.0F) * 65'535.0F + 0.5F);
+        }
+
+        // Round half up, values too small for a normal half flush to
+        // zero and values too large saturate to infinity.
+        [[nodiscard]] static constexpr std::uint16_t to_half(
+            const float value) noexcept
+        {
+            const auto bits = std::bit_cast<std::uint32_t>(value);
+            const auto sign = (bits >> 16) & 0x8000u;
+            const auto exponent =
+                static_cast<int>((bits >> 23) & 0xFFu) - 127 + 15;
+            const auto mantissa = bits & 0x7F'FFFFu;
+
+            if (exponent <= 0)
+            {
+                return static_cast<std::uint16_t>(sign);
+            }
+
+            if (exponent >= 31)
+            {
+                return static_cast<std::uint16_t>(sign | 0x7C00u);
+            }
+
+            return static_cast<std::uint16_t>(sign
+                + ((static_cast<std::uint32_t>(exponent) << 10)
+                    + ((mantissa + 0x1000u) >> 13)));
+        }
+
+        [[nodiscard]] constexpr std::size_t get_buffer_bytes() const noexcept
+        {
+            return this->m_capacity * sizeof(Record);
+        }
+
+        std::size_t m_capacity;
+        GLuint m_vertex_array;
+        GLuint m_instance_buffer;
+        std::vector<Record> m_records;
+        std::vector<Batch> m_batches;
+        unsigned long long m_sprites;
+        unsigned long long m_draws;
+        unsigned long long m_flushes;
+    };
+}
@@ -0,0 +1,350 @@
+// Texel_Pipeline.cpp
+
+module;
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) \
+    || defined(_M_IX86)
+    #define EQX_X86
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        #define EQX_TARGET_SSSE3
+        #define EQX_TARGET_AVX2
+    #else
+        #define EQX_TARGET_SSSE3 __attribute__((target("ssse3")))
+        #define EQX_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif // _MSC_VER
+#endif // x86
+
+export module Eqx.OGL.Texel_Pipeline;
+
+import <Eqx/std.hpp>;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    /*
+     * Load time texel kernels. Every stage has a scalar reference and, on
+     * x86, SSSE3 and AVX2 variants selected once at runtime. All variants
+     * produce bit identical results.
+     */
+    class Texel_Pipeline
+    {
+    public:
+        enum class Isa
+        {
+            Scalar,
+            Ssse3,
+            Avx2
+        };
+
+        Texel_Pipeline() = delete;
+        Texel_Pipeline(const Texel_Pipeline&) = delete;
+        Texel_Pipeline(Texel_Pipeline&&) = delete;
+        Texel_Pipeline& operator= (const Texel_Pipeline&) = delete;
+        Texel_Pipeline& operator= (Texel_Pipeline&&) = delete;
+        ~Texel_Pipeline() = delete;
+
+        [[nodiscard]] static inline Isa get_isa() noexcept
+        {
+            static const auto isa = Texel_Pipeline::detect();
+            return isa;
+        }
+
+        [[nodiscard]] static constexpr std::string_view to_string(
+            const Isa isa) noexcept
+        {
+            switch (isa)
+            {
+            case Isa::Avx2:
+                return "AVX2"sv;
+            case Isa::Ssse3:
+                return "SSSE3"sv;
+            default:
+                return "Scalar"sv;
+            }
+        }
+
+        static inline void expand_rgb(const std::span<const unsigned char> rgb,
+            const std::span<unsigned char> rgba,
+            const Isa isa = Texel_Pipeline::get_isa()) noexcept
+        {
+            assert(std::ranges::size(rgb) % 3 == 0);
+            assert(std::ranges::size(rgba) / 4 == std::ranges::size(rgb) / 3);
+
+            const auto count = std::ranges::size(rgb) / 3;
+            auto done = std::size_t{ 0 };
+
+#ifdef EQX_X86
+            if (isa == Isa::Avx2)
+            {
+                done = Texel_Pipeline::expand_rgb_avx2(rgb.data(),
+                    rgba.data(), count);
+            }
+            else if (isa == Isa::Ssse3)
+            {
+                done = Texel_Pipeline::expand_rgb_ssse3(rgb.data(),
+                    rgba.data(), count);
+            }
+#endif // EQX_X86
+
+            Texel_Pipeline::expand_rgb_scalar(rgb.data() + done * 3,
+                rgba.data() + done * 4, count - done);
+        }
+
+        static inline void premultiply(const std::span<unsigned char> rgba,
+            const Isa isa = Texel_Pipeline::get_isa()) noexcept
+        {
+            assert(std::ranges::size(rgba) % 4 == 0);
+
+            const auto count = std::ranges::size(rgba) / 4;
+            auto done = std::size_t{ 0 };
+
+#ifdef EQX_X86
+            if (isa == Isa::Avx2)
+            {
+                done = Texel_Pipeline::premultiply_avx2(rgba.data(), count);
+            }
+            else if (isa == Isa::Ssse3)
+            {
+                done = Texel_Pipeline::premultiply_ssse3(rgba.data(), count);
+            }
+#endif // EQX_X86
+
+            Texel_Pipeline::premultiply_scalar(rgba.data() + done * 4,
+                count - done);
+        }
+
+        /*
+         * Row swaps are plain memory moves, copying through one scratch row
+         * lowers to memmove so there is no per ISA variant.
+         */
+        static inline void flip(const std::span<unsigned char> texels,
+            const int width, const int height, const int channels) noexcept
+        {
+            assert(std::ranges::size(texels)
+                == static_cast<std::size_t>(width * height * channels));
+
+            const auto stride = static_cast<std::ptrdiff_t>(width * channels);
+            auto row = std::vector<unsigned char>(
+                static_cast<std::size_t>(stride));
+            auto top = std::ranges::begin(texels);
+            auto bottom = std::ranges::begin(texels) + stride * (height - 1);
+
+            while (top < bottom)
+            {
+                std::ranges::copy(top, top + stride, std::ranges::begin(row));
+                std::ranges::copy(bottom, bottom + stride, top);
+                std::ranges::copy(row, bottom);
+                top += stride;
+                bottom -= stride;
+            }
+        }
+
+    private:
+        [[nodiscard]] static inline Isa detect() noexcept
+        {
+#ifdef EQX_X86
+    #ifdef _MSC_VER
+            auto info = std::array<int, 4>{};
+            __cpuid(info.data(), 0);
+            const auto max_leaf = info[0];
+
+            __cpuid(info.data(), 1);
+            const auto ssse3 = (info[2] & (1 << 9)) != 0;
+            const auto osxsave = (info[2] & (1 << 27)) != 0;
+            const auto avx = (info[2] & (1 << 28)) != 0;
+
+            auto avx2 = false;
+            if (max_leaf >= 7 && osxsave && avx
+                && (_xgetbv(0) & 0x6ull) == 0x6ull)
+            {
+                __cpuidex(info.data(), 7, 0);
+                avx2 = (info[1] & (1 << 5)) != 0;
+            }
+    #else
+            const auto ssse3 = __builtin_cpu_supports("ssse3") != 0;
+            const auto avx2 = __builtin_cpu_supports("avx2") != 0;
+    #endif // _MSC_VER
+
+            if (avx2)
+            {
+                return Isa::Avx2;
+            }
+            else if (ssse3)
+            {
+                return Isa::Ssse3;
+            }
+#endif // EQX_X86
+
+            return Isa::Scalar;
+        }
+
+        [[nodiscard]] static constexpr unsigned char div255(
+            const unsigned int x) noexcept
+        {
+            const auto t = x + 128u;
+            return static_cast<unsigned char>((t + (t >> 8)) >> 8);
+        }
+
+        static inline void expand_rgb_scalar(const unsigned char* rgb,
+            unsigned char* rgba, const std::size_t count) noexcept
+        {
+            for (auto i = std::size_t{ 0 }; i < count; ++i)
+            {
+                rgba[i * 4 + 0] = rgb[i * 3 + 0];
+                rgba[i * 4 + 1] = rgb[i * 3 + 1];
+                rgba[i * 4 + 2] = rgb[i * 3 + 2];
+                rgba[i * 4 + 3] = 255u;
+            }
+        }
+
+        static inline void premultiply_scalar(unsigned char* rgba,
+            const std::size_t count) noexcept
+        {
+            for (auto i = std::size_t{ 0 }; i < count; ++i)
+            {
+                const auto a = static_cast<unsigned int>(rgba[i * 4 + 3]);
+                rgba[i * 4 + 0] = Texel_Pipeline::div255(rgba[i * 4 + 0] * a);
+                rgba[i * 4 + 1] = Texel_Pipeline::div255(rgba[i * 4 + 1] * a);
+                rgba[i * 4 + 2] = Texel_Pipeline::div255(rgba[i * 4 + 2] * a);
+            }
+        }
+
+#ifdef EQX_X86
+        // Each 16 byte load covers 5.33 pixels, only the first 4 are used so
+        // the loop stops while a full load is still in bounds.
+        EQX_TARGET_SSSE3 static inline std::size_t expand_rgb_ssse3(
+            const unsigned char* rgb, unsigned char* rgba,
+            const std::size_t count) noexcept
+        {
+            const auto shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1,
+                6, 7, 8, -1, 9, 10, 11, -1);
+            const auto alpha = _mm_set1_epi32(
+                static_cast<int>(0xFF00'0000u));
+
+            auto i = std::size_t{ 0 };
+            for (; i + 6 <= count; i += 4)
+            {
+                const auto in = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(rgb + i * 3));
+                const auto out = _mm_or_si128(_mm_shuffle_epi8(in, shuffle),
+                    alpha);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4),
+                    out);
+            }
+
+            return i;
+        }
+
+        EQX_TARGET_AVX2 static inline std::size_t expand_rgb_avx2(
+            const unsigned char* rgb, unsigned char* rgba,
+            const std::size_t count) noexcept
+        {
+            const auto shuffle = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1,
+                6, 7, 8, -1, 9, 10, 11, -1, 0, 1, 2, -1, 3, 4, 5, -1,
+                6, 7, 8, -1, 9, 10, 11, -1);
+            const auto alpha = _mm256_set1_epi32(
+                static_cast<int>(0xFF00'0000u));
+
+            auto i = std::size_t{ 0 };
+            for (; i + 10 <= count; i += 8)
+            {
+                const auto lo = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(rgb + i * 3));
+                const auto hi = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(rgb + i * 3 + 12));
+                const auto in = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(lo), hi, 1);
+                const auto out = _mm256_or_si256(
+                    _mm256_shuffle_epi8(in, shuffle), alpha);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + i * 4),
+                    out);
+            }
+
+            return i;
+        }
+
+        // x / 255 rounded, exact for every x in [0, 255 * 255].
+        EQX_TARGET_SSSE3 static inline __m128i div255_ssse3(
+            const __m128i x) noexcept
+        {
+            const auto t = _mm_add_epi16(x, _mm_set1_epi16(128));
+            return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+        }
+
+        EQX_TARGET_AVX2 static inline __m256i div255_avx2(
+            const __m256i x) noexcept
+        {
+            const auto t = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+            return _mm256_srli_epi16(
+                _mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+        }
+
+        // Alpha is multiplied by 255 so it survives the divide unchanged.
+        EQX_TARGET_SSSE3 static inline std::size_t premultiply_ssse3(
+            unsigned char* rgba, const std::size_t count) noexcept
+        {
+            const auto broadcast = _mm_setr_epi8(3, 3, 3, -1, 7, 7, 7, -1,
+                11, 11, 11, -1, 15, 15, 15, -1);
+            const auto opaque = _mm_set1_epi32(
+                static_cast<int>(0xFF00'0000u));
+            const auto zero = _mm_setzero_si128();
+
+            auto i = std::size_t{ 0 };
+            for (; i + 4 <= count; i += 4)
+            {
+                const auto px = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(rgba + i * 4));
+                const auto a = _mm_or_si128(_mm_shuffle_epi8(px, broadcast),
+                    opaque);
+
+                const auto lo = Texel_Pipeline::div255_ssse3(_mm_mullo_epi16(
+                    _mm_unpacklo_epi8(px, zero), _mm_unpacklo_epi8(a, zero)));
+                const auto hi = Texel_Pipeline::div255_ssse3(_mm_mullo_epi16(
+                    _mm_unpackhi_epi8(px, zero), _mm_unpackhi_epi8(a, zero)));
+
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(rgba + i * 4),
+                    _mm_packus_epi16(lo, hi));
+            }
+
+            return i;
+        }
+
+        EQX_TARGET_AVX2 static inline std::size_t premultiply_avx2(
+            unsigned char* rgba, const std::size_t count) noexcept
+        {
+            const auto broadcast = _mm256_setr_epi8(3, 3, 3, -1, 7, 7, 7, -1,
+                11, 11, 11, -1, 15, 15, 15, -1, 3, 3, 3, -1, 7, 7, 7, -1,
+                11, 11, 11, -1, 15, 15, 15, -1);
+            const auto opaque = _mm256_set1_epi32(
+                static_cast<int>(0xFF00'0000u));
+            const auto zero = _mm256_setzero_si256();
+
+            auto i = std::size_t{ 0 };
+            for (; i + 8 <= count; i += 8)
+            {
+                const auto px = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(rgba + i * 4));
+                const auto a = _mm256_or_si256(
+                    _mm256_shuffle_epi8(px, broadcast), opaque);
+
+                // Unpack and pack both work per 128 bit lane, so the lane
+                // order of the result matches the input.
+                const auto lo = Texel_Pipeline::div255_avx2(
+                    _mm256_mullo_epi16(_mm256_unpacklo_epi8(px, zero),
+                        _mm256_unpacklo_epi8(a, zero)));
+                const auto hi = Texel_Pipeline::div255_avx2(
+                    _mm256_mullo_epi16(_mm256_unpackhi_epi8(px, zero),
+                        _mm256_unpackhi_epi8(a, zero)));
+
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(rgba + i * 4),
+                    _mm256_packus_epi16(lo, hi));
+            }
+
+            return i;
+        }
+#endif // EQX_X86
+    };
+}
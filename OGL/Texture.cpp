@@ -2,6 +2,11 @@
 
 export module Eqx.OGL.Texture;
 
+import Eqx.OGL.Gpu_Memory;
+import Eqx.OGL.Sampler;
+import Eqx.OGL.Texel_Pipeline;
+import Eqx.OGL.Trace;
+
 import <Eqx/std.hpp>;
 import <Eqx/TPL/glad/glad.hpp>;
 import <Eqx/TPL/stb/stb_image.hpp>;
@@ -12,6 +17,26 @@ export namespace eqx::ogl
 {
     static_assert(std::same_as<GLuint, unsigned int>);
 
+    struct Texel_View
+    {
+        std::span<const unsigned char> data;
+        int width;
+        int height;
+        int channels;
+    };
+
+    /*
+     * Load time processing. Premultiplied textures must be drawn with
+     * blend_premultiplied(true), srgb stores the texels as GL_SRGB8_ALPHA8 so
+     * sampling returns linear values.
+     */
+    struct Texture_Options
+    {
+        bool premultiply;
+        bool flip;
+        bool srgb;
+    };
+
     class Texture
     {
     public:
@@ -24,11 +49,27 @@ export namespace eqx::ogl
         {
         }
 
-        explicit inline Texture(const std::filesystem::path& path) noexcept
+        explicit inline Texture(const std::filesystem::path& path,
+            const Texture_Options& options = {}) noexcept
+            :
+            m_id(0u)
+        {
+            this->init(path, options);
+        }
+
+        explicit inline Texture(const Texel_View& texels,
+            const Texture_Options& options = {}) noexcept
             :
             m_id(0u)
         {
-            this->init(path);
+            this->init(texels, options);
+        }
+
+        explicit inline Texture(const int width, const int height) noexcept
+            :
+            m_id(0u)
+        {
+            this->init(width, height);
         }
 
         constexpr Texture(Texture&& other) noexcept
@@ -51,8 +92,11 @@ export namespace eqx::ogl
             }
         }
 
-        inline void init(const std::filesystem::path& path) noexcept
+        inline void init(const std::filesystem::path& path,
+            const Texture_Options& options = {}) noexcept
         {
+            const auto zone = Zone{ "Texture::init(path)"sv };
+
             auto w = 0;
             auto h = 0;
             auto ch = 0;
@@ -61,46 +105,89 @@ export namespace eqx::ogl
                 &w, &h, &ch, 0);
             assert(data != nullptr);
 
-            auto fmt = GL_RGBA;
-            switch(ch)
-            {
-            case 1:
-                fmt = GL_RED;
-                break;
-            case 3:
-                fmt = GL_RGB;
-                break;
-            default:
-                fmt = GL_RGBA;
-                break;
-            }
+            this->init(Texel_View{
+                std::span<const unsigned char>{ data,
+                    static_cast<std::size_t>(w * h * ch) },
+                w, h, ch }, options);
+
+            stbi_image_free(data);
+
+            Gpu_Memory::set_reload(this->m_id,
+                [id = this->m_id, path, options]() noexcept
+                {
+                    Texture::reload(id, path, options);
+                });
+        }
+
+        inline void init(const Texel_View& texels,
+            const Texture_Options& options = {}) noexcept
+        {
+            assert(!this->valid());
+            assert(std::ranges::size(texels.data)
+                == static_cast<std::size_t>(
+                    texels.width * texels.height * texels.channels));
 
+            const auto zone = Zone{ "Texture::init"sv };
             glGenTextures(1, &this->m_id);
             assert(this->valid());
             this->enable(0);
-            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            Texture::upload(texels, options);
 
-            glTexImage2D(GL_TEXTURE_2D, 0, (fmt==GL_RGB?GL_RGB8:GL_RGBA8), w, h,
-                0, fmt, GL_UNSIGNED_BYTE, data);
-            glGenerateMipmap(GL_TEXTURE_2D);
+            // Single channel textures are stored as RGBA8 too.
+            Gpu_Memory::track(Gpu_Memory::Category::Texture, this->m_id,
+                Gpu_Memory::texture_bytes(texels.width, texels.height, 4,
+                    true));
 
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
                 GL_LINEAR_MIPMAP_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
             glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
 
-            stbi_image_free(data);
+        // Uninitialized RGBA8 storage without mipmaps to render into.
+        inline void init(const int width, const int height) noexcept
+        {
+            assert(!this->valid());
+            assert(width > 0 && height > 0);
+
+            glGenTextures(1, &this->m_id);
+            assert(this->valid());
+            this->enable(0);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0,
+                GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+            Gpu_Memory::track(Gpu_Memory::Category::Texture, this->m_id,
+                Gpu_Memory::texture_bytes(width, height, 4, false));
+
+            // Level 0 is the whole chain, so samplers with a mipmapped
+            // filter still find the texture complete.
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
         }
 
         inline void enable(const int i) const noexcept
         {
             assert(this->valid());
 
+            // An evicted texture is reloaded through a bind on the active
+            // unit, which has to be unit i so no other unit is disturbed.
             glActiveTexture(GL_TEXTURE0 + i);
+            Gpu_Memory::bind(Gpu_Memory::Category::Texture, this->m_id);
             glBindTexture(GL_TEXTURE_2D, this->m_id);
         }
 
+        // The sampler overrides the texture's own filter and wrap state on
+        // unit i until another sampler (or 0) is bound there.
+        inline void enable(const int i, const Sampler& sampler) const noexcept
+        {
+            this->enable(i);
+            sampler.enable(i);
+        }
+
         inline void disable(const int i) const noexcept
         {
             assert(this->valid());
@@ -109,6 +196,19 @@ export namespace eqx::ogl
             glBindTexture(GL_TEXTURE_2D, 0u);
         }
 
+        inline void set_evictable(const bool evictable) const noexcept
+        {
+            assert(this->valid());
+
+            Gpu_Memory::set_evictable(this->m_id, evictable);
+        }
+
+        [[nodiscard]] inline std::size_t get_bytes() const noexcept
+        {
+            return Gpu_Memory::get_bytes(Gpu_Memory::Category::Texture,
+                this->m_id);
+        }
+
         [[nodiscard]] constexpr GLuint get_id() const noexcept
         {
             return this->m_id;
@@ -123,6 +223,7 @@ export namespace eqx::ogl
         {
             assert(this->valid());
 
+            Gpu_Memory::untrack(Gpu_Memory::Category::Texture, this->m_id);
             glDeleteTextures(1, &this->m_id);
             this->m_id = 0u;
 
@@ -130,6 +231,92 @@ export namespace eqx::ogl
         }
 
     private:
+        // RGB is always expanded to RGBA so rows stay 4 byte aligned and the
+        // driver never has to repack texels on upload.
+        static inline void upload(const Texel_View& texels,
+            const Texture_Options& options) noexcept
+        {
+            if (texels.channels == 3 || options.premultiply || options.flip)
+            {
+                const auto prepared = Texture::prepare(texels, options);
+                Texture::upload(Texel_View{ prepared, texels.width,
+                    texels.height, texels.channels == 1 ? 1 : 4 },
+                    Texture_Options{ false, false, options.srgb });
+                return;
+            }
+
+            if (texels.channels == 1)
+            {
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, texels.width,
+                    texels.height, 0, GL_RED, GL_UNSIGNED_BYTE,
+                    texels.data.data());
+            }
+            else
+            {
+                glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+                glTexImage2D(GL_TEXTURE_2D, 0,
+                    options.srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8, texels.width,
+                    texels.height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                    texels.data.data());
+            }
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+
+        [[nodiscard]] static inline std::vector<unsigned char> prepare(
+            const Texel_View& texels, const Texture_Options& options) noexcept
+        {
+            auto prepared = std::vector<unsigned char>{};
+            auto channels = texels.channels;
+
+            if (texels.channels == 3)
+            {
+                prepared.resize(static_cast<std::size_t>(
+                    texels.width * texels.height * 4));
+                Texel_Pipeline::expand_rgb(texels.data, prepared);
+                channels = 4;
+            }
+            else
+            {
+                prepared.assign(std::ranges::begin(texels.data),
+                    std::ranges::end(texels.data));
+            }
+
+            if (options.premultiply && channels == 4)
+            {
+                Texel_Pipeline::premultiply(prepared);
+            }
+
+            if (options.flip)
+            {
+                Texel_Pipeline::flip(prepared, texels.width, texels.height,
+                    channels);
+            }
+
+            return prepared;
+        }
+
+        static inline void reload(const GLuint id,
+            const std::filesystem::path& path,
+            const Texture_Options& options) noexcept
+        {
+            auto w = 0;
+            auto h = 0;
+            auto ch = 0;
+
+            unsigned char* data = stbi_load(path.string().c_str(),
+                &w, &h, &ch, 0);
+            assert(data != nullptr);
+
+            glBindTexture(GL_TEXTURE_2D, id);
+            Texture::upload(Texel_View{
+                std::span<const unsigned char>{ data,
+                    static_cast<std::size_t>(w * h * ch) },
+                w, h, ch }, options);
+
+            stbi_image_free(data);
+        }
+
         GLuint m_id;
     };
 }
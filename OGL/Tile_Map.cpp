@@ -0,0 +1,308 @@
+// Tile_Map.cpp
+
+export module Eqx.OGL.Tile_Map;
+
+import Eqx.OGL.Sampler;
+import Eqx.OGL.Spatial_Grid;
+import Eqx.OGL.Texture;
+import Eqx.OGL.Trace;
+import Eqx.OGL.Vertex_Array;
+import Eqx.OGL.Window;
+
+import <Eqx/std.hpp>;
+import Eqx.Lib;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    /*
+     * Tile map drawn from static chunks.
+     *
+     * Tiles index a grid atlas left to right, top to bottom, c_empty marks
+     * a hole. Each chunk of chunk_size x chunk_size tiles owns a static
+     * Vertex_Array built the first time it is seen and rebuilt only after
+     * set_tile() changes one of its tiles, so an unchanging map costs one
+     * bounds test and at most one draw per chunk in view. Tile (0, 0) sits
+     * at origin with y up. Vertices are (x, y, u, v) like Sprite_Batch's,
+     * the caller enables the shader program.
+     */
+    class Tile_Map
+    {
+    public:
+        static constexpr auto c_empty = std::uint16_t{ 0xFFFF };
+
+        Tile_Map(const Tile_Map&) = delete;
+        Tile_Map& operator= (const Tile_Map&) = delete;
+        Tile_Map(Tile_Map&&) = default;
+        Tile_Map& operator= (Tile_Map&&) = default;
+        ~Tile_Map() = default;
+
+        explicit inline Tile_Map(const int width, const int height,
+            const float tile_size, const Texture& atlas,
+            const int atlas_columns, const int atlas_rows,
+            const eqx::lib::Point<float>& origin =
+                eqx::lib::Point<float>::origin(),
+            const int chunk_size = 32) noexcept
+            :
+            m_width(width),
+            m_height(height),
+            m_tile_size(tile_size),
+            m_atlas(&atlas),
+            m_atlas_columns(atlas_columns),
+            m_atlas_rows(atlas_rows),
+            m_origin(origin),
+            m_chunk_size(chunk_size),
+            m_chunks_x((width + chunk_size - 1) / chunk_size),
+            m_chunks_y((height + chunk_size - 1) / chunk_size),
+            m_tiles(static_cast<std::size_t>(width * height), c_empty),
+            m_chunks(),
+            m_drawn(0ull),
+            m_rebuilds(0ull)
+        {
+            assert(width > 0 && height > 0);
+            assert(tile_size > 0.0F);
+            assert(atlas.valid());
+            assert(atlas_columns > 0 && atlas_rows > 0);
+            assert(chunk_size > 0);
+
+            this->m_chunks.resize(
+                static_cast<std::size_t>(this->m_chunks_x * this->m_chunks_y));
+            for (auto cy = 0; cy < this->m_chunks_y; ++cy)
+            {
+                for (auto cx = 0; cx < this->m_chunks_x; ++cx)
+                {
+                    auto& chunk = this->m_chunks[this->chunk_index(cx, cy)];
+                    const auto x0 = cx * chunk_size;
+                    const auto y0 = cy * chunk_size;
+                    const auto x1 = std::min(x0 + chunk_size, width);
+                    const auto y1 = std::min(y0 + chunk_size, height);
+                    chunk.bounds = Aabb{
+                        origin.get_x() + static_cast<float>(x0) * tile_size,
+                        origin.get_y() + static_cast<float>(y0) * tile_size,
+                        origin.get_x() + static_cast<float>(x1) * tile_size,
+                        origin.get_y() + static_cast<float>(y1) * tile_size };
+                    chunk.dirty = true;
+                }
+            }
+        }
+
+        inline void set_tile(const int x, const int y,
+            const std::uint16_t tile) noexcept
+        {
+            assert(tile == c_empty
+                || tile < this->m_atlas_columns * this->m_atlas_rows);
+
+            auto& current = this->m_tiles[this->tile_index(x, y)];
+            if (current == tile)
+            {
+                return;
+            }
+
+            current = tile;
+            this->m_chunks[this->chunk_index(x / this->m_chunk_size,
+                y / this->m_chunk_size)].dirty = true;
+        }
+
+        [[nodiscard]] inline std::uint16_t get_tile(const int x,
+            const int y) const noexcept
+        {
+            return this->m_tiles[this->tile_index(x, y)];
+        }
+
+        // Dirty chunks out of view are left dirty until they come into it.
+        inline void draw(const Aabb& view, const Sampler& sampler) noexcept
+        {
+            const auto zone = Zone{ "Tile_Map::draw"sv };
+            this->m_drawn = 0ull;
+            this->m_atlas->enable(0, sampler);
+
+            const auto range = this->to_chunk_range(view);
+            for (auto cy = range[1]; cy <= range[3]; ++cy)
+            {
+                for (auto cx = range[0]; cx <= range[2]; ++cx)
+                {
+                    auto& chunk = this->m_chunks[this->chunk_index(cx, cy)];
+                    if (!chunk.bounds.overlaps(view))
+                    {
+                        continue;
+                    }
+
+                    if (chunk.dirty)
+                    {
+                        this->build(cx, cy, chunk);
+                    }
+
+                    if (chunk.vertex_array.valid())
+                    {
+                        chunk.vertex_array.enable();
+                        eqx::ogl::draw(chunk.vertex_array.get_index_count());
+                        ++this->m_drawn;
+                    }
+                }
+            }
+        }
+
+        [[nodiscard]] constexpr int get_width() const noexcept
+        {
+            return this->m_width;
+        }
+
+        [[nodiscard]] constexpr int get_height() const noexcept
+        {
+            return this->m_height;
+        }
+
+        [[nodiscard]] constexpr Aabb get_bounds() const noexcept
+        {
+            return Aabb{ this->m_origin.get_x(), this->m_origin.get_y(),
+                this->m_origin.get_x()
+                    + static_cast<float>(this->m_width) * this->m_tile_size,
+                this->m_origin.get_y()
+                    + static_cast<float>(this->m_height) * this->m_tile_size };
+        }
+
+        [[nodiscard]] inline std::size_t get_chunk_count() const noexcept
+        {
+            return std::ranges::size(this->m_chunks);
+        }
+
+        // Chunks drawn by the last draw().
+        [[nodiscard]] constexpr unsigned long long get_drawn() const noexcept
+        {
+            return this->m_drawn;
+        }
+
+        [[nodiscard]] constexpr unsigned long long
+            get_rebuilds() const noexcept
+        {
+            return this->m_rebuilds;
+        }
+
+    private:
+        struct Chunk
+        {
+            Vertex_Array vertex_array;
+            Aabb bounds;
+            bool dirty;
+        };
+
+        [[nodiscard]] inline std::size_t tile_index(const int x,
+            const int y) const noexcept
+        {
+            assert(x >= 0 && x < this->m_width);
+            assert(y >= 0 && y < this->m_height);
+
+            return static_cast<std::size_t>(y * this->m_width + x);
+        }
+
+        [[nodiscard]] inline std::size_t chunk_index(const int cx,
+            const int cy) const noexcept
+        {
+            return static_cast<std::size_t>(cy * this->m_chunks_x + cx);
+        }
+
+        [[nodiscard]] inline std::array<int, 4> to_chunk_range(
+            const Aabb& view) const noexcept
+        {
+            const auto span = this->m_tile_size
+                * static_cast<float>(this->m_chunk_size);
+            const auto cell = [span](const float v, const float o,
+                const int count) noexcept
+            {
+                return std::clamp(static_cast<int>(std::floor((v - o) / span)),
+                    0, count - 1);
+            };
+
+            return std::array<int, 4>{
+                cell(view.left, this->m_origin.get_x(), this->m_chunks_x),
+                cell(view.bottom, this->m_origin.get_y(), this->m_chunks_y),
+                cell(view.right, this->m_origin.get_x(), this->m_chunks_x),
+                cell(view.top, this->m_origin.get_y(), this->m_chunks_y) };
+        }
+
+        inline void build(const int cx, const int cy, Chunk& chunk) noexcept
+        {
+            const auto zone = Zone{ "Tile_Map::build"sv };
+
+            auto vertices = std::vector<float>{};
+            auto indices = std::vector<unsigned int>{};
+            const auto x0 = cx * this->m_chunk_size;
+            const auto y0 = cy * this->m_chunk_size;
+            const auto x1 = std::min(x0 + this->m_chunk_size, this->m_width);
+            const auto y1 = std::min(y0 + this->m_chunk_size, this->m_height);
+            const auto du = 1.0F / static_cast<float>(this->m_atlas_columns);
+            const auto dv = 1.0F / static_cast<float>(this->m_atlas_rows);
+
+            for (auto y = y0; y < y1; ++y)
+            {
+                for (auto x = x0; x < x1; ++x)
+                {
+                    const auto tile = this->get_tile(x, y);
+                    if (tile == c_empty)
+                    {
+                        continue;
+                    }
+
+                    const auto left = this->m_origin.get_x()
+                        + static_cast<float>(x) * this->m_tile_size;
+                    const auto bottom = this->m_origin.get_y()
+                        + static_cast<float>(y) * this->m_tile_size;
+                    const auto right = left + this->m_tile_size;
+                    const auto top = bottom + this->m_tile_size;
+                    const auto u0 = static_cast<float>(
+                        tile % this->m_atlas_columns) * du;
+                    const auto v0 = static_cast<float>(
+                        tile / this->m_atlas_columns) * dv;
+
+                    const auto v = static_cast<unsigned int>(
+                        std::ranges::size(vertices) / 4);
+                    vertices.insert(std::ranges::end(vertices), {
+                        right, top, u0 + du, v0,
+                        left, top, u0, v0,
+                        left, bottom, u0, v0 + dv,
+                        right, bottom, u0 + du, v0 + dv });
+                    indices.insert(std::ranges::end(indices), {
+                        v, v + 1u, v + 3u, v + 1u, v + 2u, v + 3u });
+                }
+            }
+
+            if (std::ranges::empty(indices))
+            {
+                if (chunk.vertex_array.valid())
+                {
+                    chunk.vertex_array.free();
+                }
+            }
+            else if (chunk.vertex_array.valid())
+            {
+                chunk.vertex_array.set_vertex_buffer(vertices,
+                    std::array<unsigned int, 2>{ 2u, 2u });
+                chunk.vertex_array.set_index_buffer(indices);
+            }
+            else
+            {
+                chunk.vertex_array.init(vertices,
+                    std::array<unsigned int, 2>{ 2u, 2u }, indices);
+            }
+
+            chunk.dirty = false;
+            ++this->m_rebuilds;
+        }
+
+        int m_width;
+        int m_height;
+        float m_tile_size;
+        const Texture* m_atlas;
+        int m_atlas_columns;
+        int m_atlas_rows;
+        eqx::lib::Point<float> m_origin;
+        int m_chunk_size;
+        int m_chunks_x;
+        int m_chunks_y;
+        std::vector<std::uint16_t> m_tiles;
+        std::vector<Chunk> m_chunks;
+        unsigned long long m_drawn;
+        unsigned long long m_rebuilds;
+    };
+}
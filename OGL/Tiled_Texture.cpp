@@ -0,0 +1,584 @@
+// Tiled_Texture.cpp
+
+export module Eqx.OGL.Tiled_Texture;
+
+import Eqx.OGL.Pack;
+import Eqx.OGL.Texture;
+
+import <Eqx/std.hpp>;
+import Eqx.Lib;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    struct Tile_Draw
+    {
+        const Texture* texture;
+        eqx::lib::Polygon<float, 4> geometry;
+        int level;
+    };
+
+    /*
+     * Large image streamed as tile textures per mip level.
+     *
+     * The image is tiled offline by Pack_Writer::add_tiled_texture, so the
+     * constructor only checks the pack's tile entries and queues the
+     * coarsest level. A worker thread copies single tiles out of the mapped
+     * pack on demand, which is where their pages fault in, and update()
+     * uploads them on the GL thread. No texels are kept on the CPU beyond
+     * a tile in flight, the largest usable image is bounded by the pack
+     * file rather than memory. Only tiles under the view (plus a margin)
+     * are requested, requests that leave the view before the worker
+     * reaches them are dropped, and textures are evicted least recently
+     * used first whenever the resident tiles exceed the budget. The
+     * coarsest level is always resident so there is never a hole while
+     * finer tiles arrive. The pack must outlive the Tiled_Texture, an
+     * entry that is missing or disagrees with its layout leaves it
+     * invalid and drawing nothing.
+     */
+    class Tiled_Texture
+    {
+    public:
+        Tiled_Texture(const Tiled_Texture&) = delete;
+        Tiled_Texture(Tiled_Texture&&) = delete;
+        Tiled_Texture& operator= (const Tiled_Texture&) = delete;
+        Tiled_Texture& operator= (Tiled_Texture&&) = delete;
+
+        explicit inline Tiled_Texture(const Pack& pack,
+            const std::string_view name,
+            const std::size_t budget = 64ull * 1'024ull * 1'024ull) noexcept
+            :
+            m_pack(&pack),
+            m_tile_size(0),
+            m_budget(budget),
+            m_margin(0.25F),
+            m_frame(0ull),
+            m_resident_bytes(0ull),
+            m_levels(),
+            m_resident(),
+            m_pending(),
+            m_wanted(),
+            m_draws(),
+            m_mutex(),
+            m_cv(),
+            m_requests(),
+            m_completed(),
+            m_worker()
+        {
+            if (!this->build_levels(name))
+            {
+                this->m_levels.clear();
+                return;
+            }
+
+            m_worker = std::jthread{ [this](std::stop_token token) noexcept
+                {
+                    this->work(token);
+                } };
+
+            const auto top = this->get_level_count() - 1;
+            for (auto y = 0; y < this->tiles_y(top); ++y)
+            {
+                for (auto x = 0; x < this->tiles_x(top); ++x)
+                {
+                    this->request(Tiled_Texture::key(top, x, y));
+                }
+            }
+        }
+
+        ~Tiled_Texture() = default;
+
+        inline void update(const eqx::lib::Polygon<float, 4>& map,
+            const eqx::lib::Polygon<float, 4>& view,
+            const float viewport_width) noexcept
+        {
+            ++this->m_frame;
+            this->m_draws.clear();
+            if (!this->valid())
+            {
+                return;
+            }
+
+            this->upload_completed();
+            this->m_wanted.clear();
+
+            const auto map_left = map.get_data()[1].get_x();
+            const auto map_top = map.get_data()[1].get_y();
+            const auto map_w = std::abs(
+                map.get_data()[0].get_x() - map.get_data()[1].get_x());
+            const auto map_h = std::abs(
+                map.get_data()[1].get_y() - map.get_data()[2].get_y());
+
+            const auto view_w = std::abs(
+                view.get_data()[0].get_x() - view.get_data()[1].get_x());
+            const auto view_h = std::abs(
+                view.get_data()[1].get_y() - view.get_data()[2].get_y());
+            const auto view_left = view.get_data()[1].get_x()
+                - view_w * this->m_margin;
+            const auto view_right = view.get_data()[0].get_x()
+                + view_w * this->m_margin;
+            const auto view_top = view.get_data()[1].get_y()
+                + view_h * this->m_margin;
+            const auto view_bottom = view.get_data()[2].get_y()
+                - view_h * this->m_margin;
+
+            const auto level = this->select_level(
+                (m_levels[0].width / map_w) / (viewport_width / view_w));
+
+            const auto lw = static_cast<float>(m_levels[level].width);
+            const auto lh = static_cast<float>(m_levels[level].height);
+            const auto to_tile = [this](const float texel, const int count)
+                noexcept
+                {
+                    return std::clamp(static_cast<int>(
+                        std::floor(texel / this->m_tile_size)), 0, count - 1);
+                };
+
+            const auto x0 = to_tile((view_left - map_left) / map_w * lw,
+                this->tiles_x(level));
+            const auto x1 = to_tile((view_right - map_left) / map_w * lw,
+                this->tiles_x(level));
+            const auto y0 = to_tile((map_top - view_top) / map_h * lh,
+                this->tiles_y(level));
+            const auto y1 = to_tile((map_top - view_bottom) / map_h * lh,
+                this->tiles_y(level));
+
+            const auto visible = view_right > map_left
+                && view_left < map_left + map_w
+                && view_top > map_top - map_h
+                && view_bottom < map_top;
+
+            for (auto y = y0; visible && y <= y1; ++y)
+            {
+                for (auto x = x0; x <= x1; ++x)
+                {
+                    this->emit(level, x, y, map_left, map_top, map_w, map_h);
+                }
+            }
+
+            std::ranges::stable_sort(this->m_draws, std::ranges::greater{},
+                &Tile_Draw::level);
+
+            this->prune();
+            this->evict();
+        }
+
+        [[nodiscard]] constexpr std::span<const Tile_Draw>
+            get_tiles() const noexcept
+        {
+            return this->m_draws;
+        }
+
+        [[nodiscard]] constexpr std::size_t
+            get_resident_bytes() const noexcept
+        {
+            return this->m_resident_bytes;
+        }
+
+        [[nodiscard]] inline std::size_t
+            get_resident_count() const noexcept
+        {
+            return std::ranges::size(this->m_resident);
+        }
+
+        [[nodiscard]] inline std::size_t get_pending_count() const noexcept
+        {
+            return std::ranges::size(this->m_pending);
+        }
+
+        [[nodiscard]] inline int get_level_count() const noexcept
+        {
+            return static_cast<int>(std::ranges::size(this->m_levels));
+        }
+
+        [[nodiscard]] inline bool valid() const noexcept
+        {
+            return !std::ranges::empty(this->m_levels);
+        }
+
+        constexpr void set_budget(const std::size_t budget) noexcept
+        {
+            this->m_budget = budget;
+        }
+
+        constexpr void set_margin(const float margin) noexcept
+        {
+            assert(margin >= 0.0F);
+
+            this->m_margin = margin;
+        }
+
+    private:
+        struct Level
+        {
+            int width;
+            int height;
+            std::size_t first;
+        };
+
+        struct Tile
+        {
+            Texture texture;
+            std::size_t bytes;
+            unsigned long long last_used;
+        };
+
+        struct Tile_Data
+        {
+            std::uint64_t key;
+            int width;
+            int height;
+            std::vector<unsigned char> texels;
+        };
+
+        [[nodiscard]] static constexpr std::uint64_t key(const int level,
+            const int x, const int y) noexcept
+        {
+            return (static_cast<std::uint64_t>(level) << 56)
+                | (static_cast<std::uint64_t>(x) << 28)
+                | static_cast<std::uint64_t>(y);
+        }
+
+        [[nodiscard]] static constexpr int key_level(
+            const std::uint64_t key) noexcept
+        {
+            return static_cast<int>(key >> 56);
+        }
+
+        [[nodiscard]] static constexpr int key_x(
+            const std::uint64_t key) noexcept
+        {
+            return static_cast<int>((key >> 28) & 0x0FFF'FFFFull);
+        }
+
+        [[nodiscard]] static constexpr int key_y(
+            const std::uint64_t key) noexcept
+        {
+            return static_cast<int>(key & 0x0FFF'FFFFull);
+        }
+
+        // Every tile entry must have the size the layout implies.
+        [[nodiscard]] inline bool build_levels(
+            const std::string_view name) noexcept
+        {
+            const auto entry = this->m_pack->find(name);
+            const auto tiles = this->m_pack->get_tiles(name);
+            constexpr auto max = static_cast<std::uint32_t>(
+                std::numeric_limits<int>::max());
+            if (entry == nullptr || !tiles.has_value()
+                || tiles->tile_size > 1u << 16
+                || entry->width == 0u || entry->width > max - tiles->tile_size
+                || entry->height == 0u
+                || entry->height > max - tiles->tile_size)
+            {
+                return false;
+            }
+
+            this->m_tile_size = static_cast<int>(tiles->tile_size);
+            auto width = static_cast<int>(entry->width);
+            auto height = static_cast<int>(entry->height);
+            auto first = static_cast<std::size_t>(tiles->first);
+            while (true)
+            {
+                this->m_levels.emplace_back(width, height, first);
+                const auto level = this->get_level_count() - 1;
+                first += static_cast<std::size_t>(this->tiles_x(level))
+                    * static_cast<std::size_t>(this->tiles_y(level));
+                if (first > tiles->first + std::size_t{ tiles->count }
+                    || (width <= this->m_tile_size
+                        && height <= this->m_tile_size))
+                {
+                    break;
+                }
+
+                width = std::max(width / 2, 1);
+                height = std::max(height / 2, 1);
+            }
+
+            // Tile coordinates have 28 bits in a key.
+            if (first != tiles->first + std::size_t{ tiles->count }
+                || std::ranges::size(this->m_levels) != tiles->level_count
+                || this->tiles_x(0) >= 1 << 28 || this->tiles_y(0) >= 1 << 28)
+            {
+                return false;
+            }
+
+            const auto entries = this->m_pack->get_entries();
+            for (auto level = 0; level < this->get_level_count(); ++level)
+            {
+                for (auto y = 0; y < this->tiles_y(level); ++y)
+                {
+                    for (auto x = 0; x < this->tiles_x(level); ++x)
+                    {
+                        const auto& tile = entries[this->entry_index(
+                            Tiled_Texture::key(level, x, y))];
+                        const auto [w, h] = this->tile_extent(
+                            Tiled_Texture::key(level, x, y));
+                        if (tile.kind != Pack_Kind::Texture
+                            || tile.channels != 4u
+                            || tile.width != static_cast<std::uint32_t>(w)
+                            || tile.height != static_cast<std::uint32_t>(h))
+                        {
+                            return false;
+                        }
+                    }
+                }
+            }
+
+            return true;
+        }
+
+        [[nodiscard]] inline std::size_t entry_index(
+            const std::uint64_t key) const noexcept
+        {
+            const auto level = Tiled_Texture::key_level(key);
+            return this->m_levels[level].first + static_cast<std::size_t>(
+                Tiled_Texture::key_y(key) * this->tiles_x(level)
+                    + Tiled_Texture::key_x(key));
+        }
+
+        [[nodiscard]] inline std::pair<int, int> tile_extent(
+            const std::uint64_t key) const noexcept
+        {
+            const auto& lvl = this->m_levels[Tiled_Texture::key_level(key)];
+            const auto x0 = Tiled_Texture::key_x(key) * this->m_tile_size;
+            const auto y0 = Tiled_Texture::key_y(key) * this->m_tile_size;
+            return std::make_pair(std::min(this->m_tile_size, lvl.width - x0),
+                std::min(this->m_tile_size, lvl.height - y0));
+        }
+
+        [[nodiscard]] inline int tiles_x(const int level) const noexcept
+        {
+            return (this->m_levels[level].width + this->m_tile_size - 1)
+                / this->m_tile_size;
+        }
+
+        [[nodiscard]] inline int tiles_y(const int level) const noexcept
+        {
+            return (this->m_levels[level].height + this->m_tile_size - 1)
+                / this->m_tile_size;
+        }
+
+        [[nodiscard]] inline int select_level(
+            const float texels_per_pixel) const noexcept
+        {
+            const auto level = texels_per_pixel > 1.0F
+                ? static_cast<int>(std::floor(std::log2(texels_per_pixel)))
+                : 0;
+
+            return std::clamp(level, 0, this->get_level_count() - 1);
+        }
+
+        inline void emit(const int level, const int x, const int y,
+            const float map_left, const float map_top, const float map_w,
+            const float map_h) noexcept
+        {
+            auto draw_level = level;
+            auto draw_x = x;
+            auto draw_y = y;
+            auto it = this->m_resident.find(Tiled_Texture::key(level, x, y));
+
+            if (it == std::ranges::end(this->m_resident))
+            {
+                this->m_wanted.insert(Tiled_Texture::key(level, x, y));
+                this->request(Tiled_Texture::key(level, x, y));
+
+                while (it == std::ranges::end(this->m_resident)
+                    && draw_level + 1 < this->get_level_count())
+                {
+                    ++draw_level;
+                    draw_x /= 2;
+                    draw_y /= 2;
+                    it = this->m_resident.find(
+                        Tiled_Texture::key(draw_level, draw_x, draw_y));
+                }
+
+                if (it == std::ranges::end(this->m_resident))
+                {
+                    return;
+                }
+            }
+
+            it->second.last_used = this->m_frame;
+
+            if (draw_level != level && std::ranges::any_of(this->m_draws,
+                [&it](const Tile_Draw& draw) noexcept
+                {
+                    return draw.texture == &it->second.texture;
+                }))
+            {
+                return;
+            }
+
+            const auto& lvl = this->m_levels[draw_level];
+            const auto lw = static_cast<float>(lvl.width);
+            const auto lh = static_cast<float>(lvl.height);
+            const auto tx0 = static_cast<float>(draw_x * this->m_tile_size);
+            const auto ty0 = static_cast<float>(draw_y * this->m_tile_size);
+            const auto tx1 = std::min(tx0 + this->m_tile_size, lw);
+            const auto ty1 = std::min(ty0 + this->m_tile_size, lh);
+
+            const auto left = map_left + tx0 / lw * map_w;
+            const auto right = map_left + tx1 / lw * map_w;
+            const auto top = map_top - ty0 / lh * map_h;
+            const auto bottom = map_top - ty1 / lh * map_h;
+
+            this->m_draws.emplace_back(&it->second.texture,
+                eqx::lib::Polygon<float, 4>{
+                    eqx::lib::Point<float>{ right, top },
+                    eqx::lib::Point<float>{ left, top },
+                    eqx::lib::Point<float>{ left, bottom },
+                    eqx::lib::Point<float>{ right, bottom } },
+                draw_level);
+        }
+
+        inline void request(const std::uint64_t key) noexcept
+        {
+            if (this->m_pending.contains(key))
+            {
+                return;
+            }
+
+            this->m_pending.insert(key);
+            {
+                auto lock = std::scoped_lock{ this->m_mutex };
+                this->m_requests.push_back(key);
+            }
+            this->m_cv.notify_one();
+        }
+
+        // Drops queued requests the last update() no longer asked for, the
+        // coarsest level is always kept.
+        inline void prune() noexcept
+        {
+            const auto top = this->get_level_count() - 1;
+            const auto wanted = [this, top](const std::uint64_t key) noexcept
+            {
+                return Tiled_Texture::key_level(key) == top
+                    || this->m_wanted.contains(key);
+            };
+
+            auto lock = std::scoped_lock{ this->m_mutex };
+            const auto stale = std::ranges::stable_partition(
+                this->m_requests, wanted);
+            for (const auto key : stale)
+            {
+                this->m_pending.erase(key);
+            }
+            this->m_requests.erase(std::ranges::begin(stale),
+                std::ranges::end(stale));
+        }
+
+        inline void upload_completed() noexcept
+        {
+            auto completed = std::vector<Tile_Data>{};
+            {
+                auto lock = std::scoped_lock{ this->m_mutex };
+                std::swap(completed, this->m_completed);
+            }
+
+            for (auto& data : completed)
+            {
+                const auto bytes = static_cast<std::size_t>(
+                    data.width * data.height * 4) * 4ull / 3ull;
+                this->m_pending.erase(data.key);
+                this->m_resident.emplace(data.key, Tile{
+                    Texture{ Texel_View{ data.texels, data.width,
+                        data.height, 4 } },
+                    bytes, this->m_frame });
+                this->m_resident_bytes += bytes;
+            }
+        }
+
+        inline void evict() noexcept
+        {
+            const auto top = this->get_level_count() - 1;
+
+            while (this->m_resident_bytes > this->m_budget)
+            {
+                auto victim = std::ranges::end(this->m_resident);
+                for (auto it = std::ranges::begin(this->m_resident);
+                    it != std::ranges::end(this->m_resident); ++it)
+                {
+                    if (Tiled_Texture::key_level(it->first) != top
+                        && it->second.last_used != this->m_frame
+                        && (victim == std::ranges::end(this->m_resident)
+                            || it->second.last_used
+                                < victim->second.last_used))
+                    {
+                        victim = it;
+                    }
+                }
+
+                if (victim == std::ranges::end(this->m_resident))
+                {
+                    break;
+                }
+
+                this->m_resident_bytes -= victim->second.bytes;
+                this->m_resident.erase(victim);
+            }
+        }
+
+        inline void work(std::stop_token token) noexcept
+        {
+            while (!token.stop_requested())
+            {
+                auto key = std::uint64_t{ 0 };
+                {
+                    auto lock = std::unique_lock{ this->m_mutex };
+                    if (!this->m_cv.wait(lock, token, [this]() noexcept
+                        {
+                            return !this->m_requests.empty();
+                        }))
+                    {
+                        return;
+                    }
+
+                    key = this->m_requests.front();
+                    this->m_requests.pop_front();
+                }
+
+                auto data = this->read(key);
+
+                auto lock = std::scoped_lock{ this->m_mutex };
+                this->m_completed.push_back(std::move(data));
+            }
+        }
+
+        // The copy is what faults the tile's pages in, off the GL thread.
+        [[nodiscard]] inline Tile_Data read(
+            const std::uint64_t key) const noexcept
+        {
+            const auto& entry =
+                this->m_pack->get_entries()[this->entry_index(key)];
+            const auto data = this->m_pack->get_data(entry);
+            const auto texels = reinterpret_cast<const unsigned char*>(
+                data.data());
+
+            return Tile_Data{ key, static_cast<int>(entry.width),
+                static_cast<int>(entry.height),
+                std::vector<unsigned char>(texels,
+                    texels + std::ranges::size(data)) };
+        }
+
+        const Pack* m_pack;
+        int m_tile_size;
+        std::size_t m_budget;
+        float m_margin;
+        unsigned long long m_frame;
+        std::size_t m_resident_bytes;
+        std::vector<Level> m_levels;
+        std::unordered_map<std::uint64_t, Tile> m_resident;
+        std::unordered_set<std::uint64_t> m_pending;
+        std::unordered_set<std::uint64_t> m_wanted;
+        std::vector<Tile_Draw> m_draws;
+
+        std::mutex m_mutex;
+        std::condition_variable_any m_cv;
+        std::deque<std::uint64_t> m_requests;
+        std::vector<Tile_Data> m_completed;
+        std::jthread m_worker;
+    };
+}
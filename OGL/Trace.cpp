@@ -0,0 +1,255 @@
+// Trace.cpp
+
+export module Eqx.OGL.Trace;
+
+import <Eqx/std.hpp>;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    /*
+     * CPU instrumentation. Every thread records into its own fixed ring of
+     * c_capacity events, so recording takes no locks and never allocates
+     * after a thread's first event. The ring is allocated by that event, so
+     * a thread that is named but never records costs no ring. Zone names
+     * are stored as views and must outlive the trace, string literals are
+     * the intended use. Recording is off until set_enabled(true), a
+     * disabled Zone costs one relaxed load.
+     *
+     * write() and to_json() produce Chrome Trace Event JSON, which loads in
+     * chrome://tracing and ui.perfetto.dev. They should be called while the
+     * traced threads are quiet, a ring that wraps during export may yield a
+     * mixed event.
+     */
+    class Trace
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr auto c_capacity = std::size_t{ 1 } << 16;
+
+        Trace() = delete;
+        Trace(const Trace&) = delete;
+        Trace(Trace&&) = delete;
+        Trace& operator= (const Trace&) = delete;
+        Trace& operator= (Trace&&) = delete;
+        ~Trace() = delete;
+
+        static inline void set_enabled(const bool enabled) noexcept
+        {
+            s_enabled.store(enabled, std::memory_order_relaxed);
+        }
+
+        /*
+         * Enables recording if EQX_OGL_TRACE is set and returns the path it
+         * names, the file the program should write() on exit.
+         */
+        [[nodiscard]] static inline std::optional<std::filesystem::path>
+            enable_from_env() noexcept
+        {
+            const auto* const path = std::getenv("EQX_OGL_TRACE");
+            if (path == nullptr)
+            {
+                return std::nullopt;
+            }
+
+            Trace::set_enabled(true);
+            return std::filesystem::path{ path };
+        }
+
+        [[nodiscard]] static inline bool enabled() noexcept
+        {
+            return s_enabled.load(std::memory_order_relaxed);
+        }
+
+        static inline void set_thread_name(const std::string_view name) noexcept
+        {
+            auto& buffer = Trace::local();
+            const auto lock = std::scoped_lock{ s_mutex };
+            buffer.name = name;
+        }
+
+        static inline void record(const std::string_view name,
+            const Clock::time_point begin,
+            const Clock::time_point end) noexcept
+        {
+            auto& buffer = Trace::local();
+            if (buffer.events == nullptr) [[unlikely]]
+            {
+                const auto lock = std::scoped_lock{ s_mutex };
+                buffer.events = std::make_unique<Ring>();
+            }
+
+            const auto head = buffer.head.load(std::memory_order_relaxed);
+            (*buffer.events)[head % c_capacity] = Event{ name,
+                begin - s_epoch, end - s_epoch };
+            buffer.head.store(head + 1ull, std::memory_order_release);
+        }
+
+        [[nodiscard]] static inline std::string to_json() noexcept
+        {
+            auto json = std::string{ "{\"traceEvents\":[\n"sv };
+            auto first = true;
+            const auto separate = [&json, &first]() noexcept
+                {
+                    if (!first)
+                    {
+                        json += ",\n"sv;
+                    }
+                    first = false;
+                };
+
+            const auto lock = std::scoped_lock{ s_mutex };
+            for (const auto& buffer : s_buffers)
+            {
+                separate();
+                json += std::format("{{\"name\":\"thread_name\",\"ph\":\"M\","
+                    "\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}"sv,
+                    buffer->tid, Trace::escape(buffer->name));
+
+                const auto head = buffer->head.load(std::memory_order_acquire);
+                const auto count = std::min<std::uint64_t>(head, c_capacity);
+                for (auto i = head - count; i < head; ++i)
+                {
+                    const auto& event = (*buffer->events)[i % c_capacity];
+                    separate();
+                    json += std::format("{{\"name\":\"{}\",\"ph\":\"X\","
+                        "\"pid\":1,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}"sv,
+                        Trace::escape(event.name), buffer->tid,
+                        Trace::micro(event.begin),
+                        Trace::micro(event.end - event.begin));
+                }
+            }
+
+            json += "\n]}\n"sv;
+            return json;
+        }
+
+        [[nodiscard]] static inline bool write(
+            const std::filesystem::path& path) noexcept
+        {
+            auto file = std::ofstream{ path, std::ios::binary };
+            if (!file)
+            {
+                return false;
+            }
+
+            const auto json = Trace::to_json();
+            file.write(std::ranges::data(json),
+                static_cast<std::streamsize>(std::ranges::size(json)));
+            return static_cast<bool>(file);
+        }
+
+        /*
+         * Forgets every recorded event, threads keep their rings.
+         */
+        static inline void clear() noexcept
+        {
+            const auto lock = std::scoped_lock{ s_mutex };
+            for (auto& buffer : s_buffers)
+            {
+                buffer->head.store(0ull, std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        struct Event
+        {
+            std::string_view name;
+            Clock::duration begin;
+            Clock::duration end;
+        };
+
+        using Ring = std::array<Event, c_capacity>;
+
+        struct Buffer
+        {
+            std::unique_ptr<Ring> events;
+            std::atomic<std::uint64_t> head;
+            std::uint32_t tid;
+            std::string name;
+        };
+
+        [[nodiscard]] static inline Buffer& local() noexcept
+        {
+            if (s_local == nullptr) [[unlikely]]
+            {
+                const auto lock = std::scoped_lock{ s_mutex };
+                auto& buffer = s_buffers.emplace_back(
+                    std::make_unique<Buffer>());
+                buffer->head.store(0ull, std::memory_order_relaxed);
+                buffer->tid = static_cast<std::uint32_t>(
+                    std::ranges::size(s_buffers));
+                buffer->name = std::format("Thread {}"sv, buffer->tid);
+                s_local = buffer.get();
+            }
+
+            return *s_local;
+        }
+
+        [[nodiscard]] static inline double micro(
+            const Clock::duration duration) noexcept
+        {
+            return std::chrono::duration<double, std::micro>{
+                duration }.count();
+        }
+
+        [[nodiscard]] static inline std::string escape(
+            const std::string_view text) noexcept
+        {
+            auto escaped = std::string{};
+            escaped.reserve(std::ranges::size(text));
+            for (const auto c : text)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    escaped += '\\';
+                }
+                escaped += c;
+            }
+
+            return escaped;
+        }
+
+        static inline auto s_mutex = std::mutex{};
+        static inline auto s_buffers = std::vector<std::unique_ptr<Buffer>>{};
+        static inline thread_local Buffer* s_local = nullptr;
+        static inline const auto s_epoch = Clock::now();
+        constinit static inline auto s_enabled = std::atomic<bool>{ false };
+    };
+
+    /*
+     * Records the time between construction and destruction under name.
+     */
+    class Zone
+    {
+    public:
+        Zone(const Zone&) = delete;
+        Zone(Zone&&) = delete;
+        Zone& operator= (const Zone&) = delete;
+        Zone& operator= (Zone&&) = delete;
+
+        explicit inline Zone(const std::string_view name) noexcept
+            :
+            m_name(name),
+            m_begin(Trace::enabled()
+                ? Trace::Clock::now()
+                : Trace::Clock::time_point::min())
+        {
+        }
+
+        inline ~Zone() noexcept
+        {
+            if (this->m_begin != Trace::Clock::time_point::min())
+            {
+                Trace::record(this->m_name, this->m_begin,
+                    Trace::Clock::now());
+            }
+        }
+
+    private:
+        std::string_view m_name;
+        Trace::Clock::time_point m_begin;
+    };
+}
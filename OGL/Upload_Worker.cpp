@@ -0,0 +1,212 @@
+// Upload_Worker.cpp
+
+export module Eqx.OGL.Upload_Worker;
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glad/glad.hpp>;
+import <Eqx/TPL/glfw/glfw.hpp>;
+import Eqx.OGL.Gpu_Memory;
+import Eqx.OGL.Trace;
+import Eqx.OGL.Window;
+
+using namespace std::literals;
+
+export namespace eqx::ogl
+{
+    /*
+     * A worker thread with a hidden context that shares objects with a
+     * Window's. submit()ted work runs on the worker, usually creating and
+     * filling buffers, textures or programs, followed by a fence. poll(),
+     * called once a frame from the Window's thread, runs the ready callback
+     * of every job whose fence has signalled, at which point the objects it
+     * created are complete and may be bound there. Resources the worker
+     * tracks in Gpu_Memory never evict anything from its context, poll()
+     * enforces the budget instead. Must be constructed and destroyed on
+     * the thread that created the Window, with its context current when
+     * destroyed.
+     */
+    class Upload_Worker
+    {
+    public:
+        Upload_Worker(const Upload_Worker&) = delete;
+        Upload_Worker(Upload_Worker&&) = delete;
+        Upload_Worker& operator= (const Upload_Worker&) = delete;
+        Upload_Worker& operator= (Upload_Worker&&) = delete;
+
+        explicit inline Upload_Worker(const Window& window) noexcept
+            :
+            m_context(nullptr),
+            m_mutex(),
+            m_condition(),
+            m_jobs(),
+            m_done(),
+            m_pending(0ull),
+            m_thread()
+        {
+            assert(window.get_handle() != nullptr);
+
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            this->m_context = glfwCreateWindow(1, 1, "Upload_Worker", nullptr,
+                window.get_handle());
+            glfwWindowHint(GLFW_VISIBLE, headless() ? GLFW_FALSE : GLFW_TRUE);
+            assert(this->m_context != nullptr);
+
+            this->m_thread = std::jthread{ [this](std::stop_token token)
+                {
+                    this->work(token);
+                } };
+        }
+
+        inline ~Upload_Worker() noexcept
+        {
+            this->m_thread.request_stop();
+            this->m_thread.join();
+
+            for (auto& done : this->m_done)
+            {
+                glDeleteSync(done.fence);
+            }
+            glfwDestroyWindow(this->m_context);
+        }
+
+        /*
+         * Thread safe. work runs on the worker with its context current,
+         * ready runs inside a later poll().
+         */
+        inline void submit(std::function<void()> work,
+            std::function<void()> ready = {}) noexcept
+        {
+            this->m_pending.fetch_add(1ull, std::memory_order_relaxed);
+            {
+                const auto lock = std::scoped_lock{ this->m_mutex };
+                this->m_jobs.emplace_back(std::move(work), std::move(ready));
+            }
+            this->m_condition.notify_one();
+        }
+
+        /*
+         * Never blocks, returns how many jobs completed.
+         */
+        inline std::size_t poll() noexcept
+        {
+            auto ready = std::vector<std::function<void()>>{};
+            {
+                const auto lock = std::scoped_lock{ this->m_mutex };
+                auto it = std::ranges::begin(this->m_done);
+                for (; it != std::ranges::end(this->m_done); ++it)
+                {
+                    const auto status = glClientWaitSync(it->fence, 0, 0);
+                    if (status != GL_ALREADY_SIGNALED
+                        && status != GL_CONDITION_SATISFIED)
+                    {
+                        break;
+                    }
+
+                    glDeleteSync(it->fence);
+                    ready.push_back(std::move(it->ready));
+                }
+                this->m_done.erase(std::ranges::begin(this->m_done), it);
+            }
+
+            for (const auto& callback : ready)
+            {
+                if (callback)
+                {
+                    callback();
+                }
+            }
+
+            if (!std::ranges::empty(ready))
+            {
+                Gpu_Memory::enforce_budget();
+            }
+
+            this->m_pending.fetch_sub(std::ranges::size(ready),
+                std::memory_order_relaxed);
+            return std::ranges::size(ready);
+        }
+
+        /*
+         * Blocks until every submitted job has completed and run its ready
+         * callback.
+         */
+        inline void finish() noexcept
+        {
+            while (this->get_pending() != 0ull)
+            {
+                if (this->poll() == 0ull)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        [[nodiscard]] inline std::size_t get_pending() const noexcept
+        {
+            return this->m_pending.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct Job
+        {
+            std::function<void()> work;
+            std::function<void()> ready;
+        };
+
+        struct Done
+        {
+            GLsync fence;
+            std::function<void()> ready;
+        };
+
+        inline void work(const std::stop_token& token) noexcept
+        {
+            glfwMakeContextCurrent(this->m_context);
+            Trace::set_thread_name("Upload_Worker"sv);
+            Gpu_Memory::defer_eviction(true);
+
+            while (true)
+            {
+                auto job = Job{};
+                {
+                    auto lock = std::unique_lock{ this->m_mutex };
+                    if (!this->m_condition.wait(lock, token, [this]() noexcept
+                        {
+                            return !std::ranges::empty(this->m_jobs);
+                        }))
+                    {
+                        break;
+                    }
+
+                    job = std::move(this->m_jobs.front());
+                    this->m_jobs.pop_front();
+                }
+
+                {
+                    const auto zone = Zone{ "Upload_Worker::job"sv };
+                    job.work();
+                }
+
+                // The flush makes sure the fence reaches the GPU, a context
+                // waiting on an unflushed fence from another context could
+                // wait forever.
+                const auto fence =
+                    glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+                glFlush();
+
+                const auto lock = std::scoped_lock{ this->m_mutex };
+                this->m_done.emplace_back(fence, std::move(job.ready));
+            }
+
+            glfwMakeContextCurrent(nullptr);
+        }
+
+        GLFWwindow* m_context;
+        std::mutex m_mutex;
+        std::condition_variable_any m_condition;
+        std::deque<Job> m_jobs;
+        std::vector<Done> m_done;
+        std::atomic<std::size_t> m_pending;
+        std::jthread m_thread;
+    };
+}
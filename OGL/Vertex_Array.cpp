@@ -3,10 +3,13 @@
 export module Eqx.OGL.Vertex_Array;
 
 import Eqx.OGL.Buffer;
+import Eqx.OGL.Trace;
 
 import <Eqx/std.hpp>;
 import <Eqx/TPL/glad/glad.hpp>;
 
+using namespace std::literals;
+
 export namespace eqx::ogl
 {
     static_assert(std::same_as<GLuint, unsigned int>);
@@ -20,6 +23,7 @@ export namespace eqx::ogl
         explicit constexpr Vertex_Array() noexcept
             :
             m_id(0u),
+            m_index_count(0ull),
             m_vertex_buffer(),
             m_index_buffer()
         {
@@ -30,6 +34,7 @@ export namespace eqx::ogl
             const std::span<const unsigned int> index_data) noexcept
             :
             m_id(0u),
+            m_index_count(0ull),
             m_vertex_buffer(),
             m_index_buffer()
         {
@@ -99,6 +104,7 @@ export namespace eqx::ogl
         {
             assert(std::ranges::size(attribs) <= 8);
 
+            const auto zone = Zone{ "Vertex_Array::set_vertex_buffer"sv };
             this->enable();
             m_vertex_buffer.buffer_data(vertices);
 
@@ -128,6 +134,7 @@ export namespace eqx::ogl
         inline void set_index_buffer(
             const std::span<const unsigned int> indices) noexcept
         {
+            const auto zone = Zone{ "Vertex_Array::set_index_buffer"sv };
             this->enable();
             this->m_index_buffer.buffer_data(indices);
             this->m_index_count = std::ranges::size(indices);
@@ -138,6 +145,12 @@ export namespace eqx::ogl
             return this->m_id;
         }
 
+        [[nodiscard]] inline std::size_t get_bytes() const noexcept
+        {
+            return this->m_vertex_buffer.get_bytes()
+                + this->m_index_buffer.get_bytes();
+        }
+
         [[nodiscard]] constexpr std::size_t get_index_count() const noexcept
         {
             return this->m_index_count;
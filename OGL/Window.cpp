@@ -6,13 +6,80 @@ import <Eqx/std.hpp>;
 import <Eqx/TPL/glad/glad.hpp>;
 import <Eqx/TPL/glfw/glfw.hpp>;
 import Eqx.Lib;
+import Eqx.OGL.Gpu_Profiler;
+import Eqx.OGL.Input;
+import Eqx.OGL.Trace;
 
 using namespace std::literals;
 
 export namespace eqx::ogl
 {
-    inline void init() noexcept
+    /*
+     * Windowed opens a regular GLFW window. Egl and OSMesa use the GLFW null
+     * platform with a surfaceless EGL (EGL_MESA_platform_surfaceless) or an
+     * OSMesa context, so no display server or GPU is needed, and each Window
+     * renders into its own framebuffer object instead.
+     */
+    enum class Backend
     {
+        Windowed,
+        Egl,
+        OSMesa
+    };
+}
+
+namespace eqx::ogl
+{
+    constinit inline auto s_backend = Backend::Windowed;
+}
+
+export namespace eqx::ogl
+{
+    /*
+     * EQX_OGL_BACKEND=egl or EQX_OGL_BACKEND=osmesa switch every program to
+     * a headless context without rebuilding, anything else is Windowed.
+     */
+    [[nodiscard]] inline Backend backend_from_env() noexcept
+    {
+        const auto* const env = std::getenv("EQX_OGL_BACKEND");
+        if (env == nullptr)
+        {
+            return Backend::Windowed;
+        }
+
+        const auto name = std::string_view{ env };
+        if (name == "egl"sv)
+        {
+            return Backend::Egl;
+        }
+        else if (name == "osmesa"sv)
+        {
+            return Backend::OSMesa;
+        }
+        else
+        {
+            return Backend::Windowed;
+        }
+    }
+
+    [[nodiscard]] inline Backend get_backend() noexcept
+    {
+        return s_backend;
+    }
+
+    [[nodiscard]] inline bool headless() noexcept
+    {
+        return s_backend != Backend::Windowed;
+    }
+
+    inline void init(const Backend backend = backend_from_env()) noexcept
+    {
+        s_backend = backend;
+        if (headless())
+        {
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        }
+
         [[maybe_unused]] const auto ec = glfwInit();
         assert(ec != GLFW_FALSE);
 
@@ -29,6 +96,15 @@ export namespace eqx::ogl
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+        if (headless())
+        {
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API,
+                backend == Backend::Egl
+                    ? GLFW_EGL_CONTEXT_API
+                    : GLFW_OSMESA_CONTEXT_API);
+        }
     }
 
     inline void free() noexcept
@@ -42,6 +118,19 @@ export namespace eqx::ogl
             GL_UNSIGNED_INT, 0);
     }
 
+    inline void blend_premultiplied(const bool on) noexcept
+    {
+        if (on)
+        {
+            glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        }
+        else
+        {
+            glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
+                GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        }
+    }
+
     class Window
     {
     public:
@@ -74,32 +163,69 @@ export namespace eqx::ogl
             Down = GLFW_PRESS
         };
 
+        /*
+         * Adaptive syncs like Vsync but tears instead of waiting a whole
+         * refresh when a frame is late, it falls back to Vsync where the
+         * swap_control_tear extension is missing.
+         */
+        enum class Present_Mode
+        {
+            Immediate,
+            Vsync,
+            Adaptive
+        };
+
         Window(const Window&) = delete;
         Window& operator= (const Window&) = delete;
 
-        explicit constexpr Window() noexcept
+        explicit inline Window() noexcept
             :
-            m_window(nullptr)
+            m_window(nullptr),
+            m_framebuffer(0u),
+            m_color(0u),
+            m_input(nullptr),
+            m_present_mode(Present_Mode::Vsync),
+            m_max_frames_in_flight(0),
+            m_in_flight()
         {
         }
 
         explicit inline Window(const int width, const int height,
             const std::string_view name) noexcept
             :
-            m_window(nullptr)
+            m_window(nullptr),
+            m_framebuffer(0u),
+            m_color(0u),
+            m_input(nullptr),
+            m_present_mode(Present_Mode::Vsync),
+            m_max_frames_in_flight(0),
+            m_in_flight()
         {
             this->init(width, height, name);
         }
 
         inline Window(Window&& other) noexcept
             :
-            m_window(std::exchange(other.m_window, nullptr))
+            m_window(std::exchange(other.m_window, nullptr)),
+            m_framebuffer(std::exchange(other.m_framebuffer, 0u)),
+            m_color(std::exchange(other.m_color, 0u)),
+            m_input(std::move(other.m_input)),
+            m_present_mode(other.m_present_mode),
+            m_max_frames_in_flight(other.m_max_frames_in_flight),
+            m_in_flight(std::move(other.m_in_flight))
         {
         }
 
         inline Window& operator= (Window&& other) noexcept
         {
             std::swap(m_window, other.m_window);
+            std::swap(this->m_framebuffer, other.m_framebuffer);
+            std::swap(this->m_color, other.m_color);
+            std::swap(this->m_input, other.m_input);
+            std::swap(this->m_present_mode, other.m_present_mode);
+            std::swap(this->m_max_frames_in_flight,
+                other.m_max_frames_in_flight);
+            std::swap(this->m_in_flight, other.m_in_flight);
         }
 
         inline ~Window() noexcept
@@ -124,18 +250,16 @@ export namespace eqx::ogl
                 reinterpret_cast<GLADloadproc>(glfwGetProcAddress));
             assert(ec != 0);
 
-            glfwSetScrollCallback(this->m_window,
-                [] ([[maybe_unused]] GLFWwindow* window, double xoffset,
-                double yoffset) noexcept -> void
-                {
-                    s_scroll_offset.translate(eqx::lib::Point<float>{
-                        static_cast<float>(xoffset),
-                        static_cast<float>(yoffset) });
-                });
+            this->m_input = std::make_unique<Input>();
+            this->m_input->attach(this->m_window);
+
+            if (headless())
+            {
+                this->init_framebuffer(width, height);
+            }
 
             glEnable(GL_BLEND);
-            glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
-                GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+            blend_premultiplied(false);
 
             glViewport(0, 0, width, height);
             glfwSetFramebufferSizeCallback(m_window,
@@ -151,20 +275,30 @@ export namespace eqx::ogl
         {
             assert(m_window != nullptr);
 
+            for (const auto fence : this->m_in_flight)
+            {
+                glDeleteSync(fence);
+            }
+            this->m_in_flight.clear();
+            Gpu_Profiler::free();
+
+            if (this->m_framebuffer != 0u)
+            {
+                glDeleteFramebuffers(1, &this->m_framebuffer);
+                glDeleteRenderbuffers(1, &this->m_color);
+                this->m_framebuffer = 0u;
+                this->m_color = 0u;
+            }
+
             glfwDestroyWindow(m_window);
             m_window = nullptr;
+            this->m_input.reset();
         }
 
         [[nodiscard]] inline eqx::lib::Point<float>
             get_cursor_location() const noexcept
         {
-            assert(m_window != nullptr);
-
-            auto x = 0.0;
-            auto y = 0.0;
-            glfwGetCursorPos(m_window, &x, &y);
-            return eqx::lib::Point<float>{ static_cast<float>(x),
-                static_cast<float>(-y) };
+            return this->get_input().get_cursor();
         }
 
         [[nodiscard]] inline eqx::lib::Point<float>
@@ -182,11 +316,8 @@ export namespace eqx::ogl
         [[nodiscard]] inline Key_State mouse_button_state(
             Mouse_Button button) const noexcept
         {
-            assert(m_window != nullptr);
-
-            return static_cast<Key_State>(
-                glfwGetMouseButton(this->m_window,
-                    static_cast<decltype(GLFW_MOUSE_BUTTON_LEFT)>(button)));
+            return this->get_input().mouse_button_down(
+                static_cast<int>(button)) ? Key_State::Down : Key_State::Up;
         }
 
         [[nodiscard]] inline bool mouse_button_down(
@@ -203,10 +334,8 @@ export namespace eqx::ogl
 
         [[nodiscard]] inline Key_State key_state(Key key) const noexcept
         {
-            assert(m_window != nullptr);
-
-            return static_cast<Key_State>(
-                glfwGetKey(m_window, static_cast<decltype(GLFW_KEY_W)>(key)));
+            return this->get_input().key_down(static_cast<int>(key))
+                ? Key_State::Down : Key_State::Up;
         }
 
         [[nodiscard]] inline bool key_down(Key key) const noexcept
@@ -219,6 +348,26 @@ export namespace eqx::ogl
             return !this->key_down(key);
         }
 
+        [[nodiscard]] inline bool key_pressed(Key key) const noexcept
+        {
+            return this->get_input().key_pressed(static_cast<int>(key));
+        }
+
+        [[nodiscard]] inline bool key_released(Key key) const noexcept
+        {
+            return this->get_input().key_released(static_cast<int>(key));
+        }
+
+        /*
+         * Input as of the last poll(), reading it makes no GLFW calls.
+         */
+        [[nodiscard]] inline const Input_State& get_input() const noexcept
+        {
+            assert(this->m_input != nullptr);
+
+            return this->m_input->get_snapshot();
+        }
+
         inline void set_name(const std::string_view name) const noexcept
         {
             assert(m_window != nullptr);
@@ -226,9 +375,90 @@ export namespace eqx::ogl
             glfwSetWindowTitle(m_window, name.data());
         }
 
-        inline void vsync(const bool on) const noexcept
+        inline void make_context_current() const noexcept
+        {
+            assert(m_window != nullptr);
+
+            glfwMakeContextCurrent(this->m_window);
+            if (this->m_framebuffer != 0u)
+            {
+                glBindFramebuffer(GL_FRAMEBUFFER, this->m_framebuffer);
+            }
+        }
+
+        /*
+         * Detaches the context from the calling thread so another thread
+         * can make it current, see Render_Thread.
+         */
+        inline void release_context() const noexcept
+        {
+            glfwMakeContextCurrent(nullptr);
+        }
+
+        inline void vsync(const bool on) noexcept
         {
-            glfwSwapInterval(on == true ? 1 : 0);
+            this->set_present_mode(on == true
+                ? Present_Mode::Vsync : Present_Mode::Immediate);
+        }
+
+        /*
+         * Must be called with the context current, returns the mode that
+         * was actually applied.
+         */
+        inline Present_Mode set_present_mode(const Present_Mode mode) noexcept
+        {
+            this->m_present_mode = mode;
+            if (mode == Present_Mode::Adaptive
+                && glfwExtensionSupported("WGL_EXT_swap_control_tear")
+                    == GLFW_FALSE
+                && glfwExtensionSupported("GLX_EXT_swap_control_tear")
+                    == GLFW_FALSE)
+            {
+                this->m_present_mode = Present_Mode::Vsync;
+            }
+
+            switch (this->m_present_mode)
+            {
+            case Present_Mode::Immediate:
+                glfwSwapInterval(0);
+                break;
+            case Present_Mode::Vsync:
+                glfwSwapInterval(1);
+                break;
+            case Present_Mode::Adaptive:
+                glfwSwapInterval(-1);
+                break;
+            }
+
+            return this->m_present_mode;
+        }
+
+        [[nodiscard]] constexpr Present_Mode get_present_mode() const noexcept
+        {
+            return this->m_present_mode;
+        }
+
+        /*
+         * Caps how many swapped frames the driver may queue ahead of the
+         * GPU, 0 leaves it to the driver. 1 waits for every frame with
+         * glFinish, which gives the lowest input to photon latency at the
+         * cost of CPU/GPU overlap, larger values wait on fences.
+         */
+        inline void set_max_frames_in_flight(const int frames) noexcept
+        {
+            assert(frames >= 0);
+
+            this->m_max_frames_in_flight = frames;
+            while (std::ssize(this->m_in_flight) > std::max(frames - 1, 0))
+            {
+                glDeleteSync(this->m_in_flight.front());
+                this->m_in_flight.pop_front();
+            }
+        }
+
+        [[nodiscard]] constexpr int get_max_frames_in_flight() const noexcept
+        {
+            return this->m_max_frames_in_flight;
         }
 
         inline void clear() const noexcept
@@ -238,18 +468,69 @@ export namespace eqx::ogl
             glClear(GL_COLOR_BUFFER_BIT);
         }
 
-        inline void swap() const noexcept
+        inline void swap() noexcept
         {
             assert(m_window != nullptr);
 
-            glfwSwapBuffers(m_window);
+            const auto zone = Zone{ "Window::swap"sv };
+
+            if (this->m_framebuffer != 0u)
+            {
+                glFlush();
+            }
+            else
+            {
+                glfwSwapBuffers(m_window);
+            }
+            Gpu_Profiler::new_frame();
+
+            if (this->m_max_frames_in_flight == 1)
+            {
+                glFinish();
+            }
+            else if (this->m_max_frames_in_flight > 1)
+            {
+                this->m_in_flight.push_back(
+                    glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+                while (std::ssize(this->m_in_flight)
+                    >= this->m_max_frames_in_flight)
+                {
+                    glClientWaitSync(this->m_in_flight.front(),
+                        GL_SYNC_FLUSH_COMMANDS_BIT,
+                        std::numeric_limits<GLuint64>::max());
+                    glDeleteSync(this->m_in_flight.front());
+                    this->m_in_flight.pop_front();
+                }
+            }
         }
 
         inline void poll() const noexcept
         {
             assert(m_window != nullptr);
 
+            const auto zone = Zone{ "Window::poll"sv };
             glfwPollEvents();
+            this->m_input->snapshot();
+        }
+
+        /*
+         * poll() for loops with nothing to do until the user acts, blocks
+         * until an event arrives or timeout seconds pass. wake() ends the
+         * wait early from any thread.
+         */
+        inline void wait(const double timeout) const noexcept
+        {
+            assert(m_window != nullptr);
+            assert(timeout > 0.0);
+
+            const auto zone = Zone{ "Window::wait"sv };
+            glfwWaitEventsTimeout(timeout);
+            this->m_input->snapshot();
+        }
+
+        static inline void wake() noexcept
+        {
+            glfwPostEmptyEvent();
         }
 
         inline bool should_close() const noexcept
@@ -266,27 +547,104 @@ export namespace eqx::ogl
             glfwSetWindowShouldClose(m_window, GLFW_TRUE);
         }
 
-        [[nodiscard]] static inline const eqx::lib::Point<float>&
-            get_scroll_offset() noexcept
+        [[nodiscard]] constexpr GLFWwindow* get_handle() const noexcept
+        {
+            return this->m_window;
+        }
+
+        /*
+         * The framebuffer the Window presents, 0 unless headless. Code that
+         * binds its own render targets must rebind this one afterwards.
+         */
+        [[nodiscard]] constexpr GLuint get_framebuffer() const noexcept
         {
-            return s_scroll_offset;
+            return this->m_framebuffer;
         }
 
-        static inline void reset_scroll_offset() noexcept
+        // In pixels, which differs from the window size on high DPI screens.
+        [[nodiscard]] inline std::pair<int, int>
+            get_framebuffer_size() const noexcept
         {
-            s_scroll_offset = eqx::lib::Point<float>::origin();
+            assert(m_window != nullptr);
+
+            auto width = 0;
+            auto height = 0;
+            glfwGetFramebufferSize(this->m_window, &width, &height);
+
+            return std::make_pair(width, height);
+        }
+
+        /*
+         * Tightly packed RGBA rows of the current frame, bottom row first.
+         */
+        [[nodiscard]] inline std::vector<unsigned char>
+            read_pixels() const noexcept
+        {
+            const auto [width, height] = this->get_framebuffer_size();
+
+            auto pixels = std::vector<unsigned char>(
+                static_cast<std::size_t>(width * height * 4));
+            glBindFramebuffer(GL_READ_FRAMEBUFFER, this->m_framebuffer);
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+                std::ranges::data(pixels));
+
+            return pixels;
+        }
+
+        [[nodiscard]] inline const eqx::lib::Point<float>&
+            get_scroll_offset() const noexcept
+        {
+            return this->get_input().get_scroll();
         }
 
     private:
+        inline void init_framebuffer(const int width, const int height) noexcept
+        {
+            glGenRenderbuffers(1, &this->m_color);
+            glBindRenderbuffer(GL_RENDERBUFFER, this->m_color);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+            glGenFramebuffers(1, &this->m_framebuffer);
+            glBindFramebuffer(GL_FRAMEBUFFER, this->m_framebuffer);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                GL_RENDERBUFFER, this->m_color);
+            assert(glCheckFramebufferStatus(GL_FRAMEBUFFER)
+                == GL_FRAMEBUFFER_COMPLETE);
+        }
+
         GLFWwindow* m_window;
+        GLuint m_framebuffer;
+        GLuint m_color;
+        std::unique_ptr<Input> m_input;
+        Present_Mode m_present_mode;
+        int m_max_frames_in_flight;
+        std::deque<GLsync> m_in_flight;
+    };
 
-        constinit static inline auto s_scroll_offset =
-            eqx::lib::Point<float>::origin();
+    struct Frame_Stats
+    {
+        float p50;
+        float p95;
+        float p99;
+        float max;
     };
 
+    /*
+     * Besides the once a second average, every frame time in milliseconds
+     * goes into a ring of the last c_capacity frames that percentiles and
+     * the histogram are computed from. A frame longer than the hitch factor
+     * times the median counts as a hitch, the median is refreshed every
+     * c_median_interval frames. Nothing allocates.
+     */
     class Frame_Timer
     {
     public:
+        static constexpr auto c_capacity = std::size_t{ 1'024 };
+        static constexpr auto c_buckets = std::size_t{ 17 };
+        static constexpr auto c_bucket_ms = 2.0F;
+        static constexpr auto c_median_interval = std::size_t{ 64 };
+
         Frame_Timer(const Frame_Timer&) = default;
         Frame_Timer(Frame_Timer&&) = default;
         Frame_Timer& operator= (const Frame_Timer&) = default;
@@ -297,13 +655,38 @@ export namespace eqx::ogl
             :
             m_timer(),
             m_fps(0.0F),
-            m_frames(0ULL)
+            m_frames(0ULL),
+            m_last(std::chrono::steady_clock::now()),
+            m_times(),
+            m_count(0ull),
+            m_median(0.0F),
+            m_hitch_factor(2.0F),
+            m_hitches(0ull)
         {
             m_timer.start();
         }
 
         inline void update() noexcept
         {
+            const auto now = std::chrono::steady_clock::now();
+            const auto ms = std::chrono::duration<float, std::milli>(
+                now - this->m_last).count();
+            this->m_last = now;
+
+            this->m_times[this->m_count % c_capacity] = ms;
+            ++this->m_count;
+
+            if (this->m_count % c_median_interval == 0ull) [[unlikely]]
+            {
+                this->m_median = this->get_percentile(0.5F);
+            }
+
+            if (this->m_median > 0.0F
+                && ms > this->m_median * this->m_hitch_factor) [[unlikely]]
+            {
+                ++this->m_hitches;
+            }
+
             ++this->m_frames;
             if (this->m_timer.readf() >= 1.0F) [[unlikely]]
             {
@@ -323,9 +706,108 @@ export namespace eqx::ogl
             return this->m_frames;
         }
 
+        [[nodiscard]] inline float get_frame_time() const noexcept
+        {
+            return this->m_count == 0ull
+                ? 0.0F
+                : this->m_times[(this->m_count - 1ull) % c_capacity];
+        }
+
+        /*
+         * Nearest rank percentile of the recorded frames, p in [0, 1].
+         */
+        [[nodiscard]] inline float get_percentile(const float p) const noexcept
+        {
+            assert(p >= 0.0F && p <= 1.0F);
+
+            auto sorted = this->m_times;
+            const auto samples = this->get_samples(sorted);
+            if (std::ranges::empty(samples))
+            {
+                return 0.0F;
+            }
+
+            const auto nth = std::ranges::begin(samples) + Frame_Timer::rank(
+                p, std::ranges::size(samples));
+            std::ranges::nth_element(samples, nth);
+            return *nth;
+        }
+
+        [[nodiscard]] inline Frame_Stats get_stats() const noexcept
+        {
+            auto sorted = this->m_times;
+            const auto samples = this->get_samples(sorted);
+            if (std::ranges::empty(samples))
+            {
+                return Frame_Stats{ 0.0F, 0.0F, 0.0F, 0.0F };
+            }
+
+            std::ranges::sort(samples);
+            const auto at = [&samples](const float p) noexcept
+                {
+                    return samples[Frame_Timer::rank(p,
+                        std::ranges::size(samples))];
+                };
+
+            return Frame_Stats{ at(0.5F), at(0.95F), at(0.99F),
+                samples.back() };
+        }
+
+        /*
+         * Bucket i counts frames in [i, i + 1) * c_bucket_ms, the last bucket
+         * also takes everything slower.
+         */
+        [[nodiscard]] inline std::array<unsigned int, c_buckets>
+            get_histogram() const noexcept
+        {
+            auto histogram = std::array<unsigned int, c_buckets>{};
+            const auto count = std::min<std::size_t>(this->m_count,
+                c_capacity);
+            for (auto i = std::size_t{ 0 }; i < count; ++i)
+            {
+                const auto bucket = static_cast<std::size_t>(
+                    this->m_times[i] / c_bucket_ms);
+                ++histogram[std::min(bucket, c_buckets - 1)];
+            }
+
+            return histogram;
+        }
+
+        inline void set_hitch_factor(const float factor) noexcept
+        {
+            assert(factor > 1.0F);
+
+            this->m_hitch_factor = factor;
+        }
+
+        [[nodiscard]] constexpr unsigned long long get_hitches() const noexcept
+        {
+            return this->m_hitches;
+        }
+
     private:
+        [[nodiscard]] inline std::span<float> get_samples(
+            std::array<float, c_capacity>& times) const noexcept
+        {
+            return std::span<float>{ times }.first(
+                std::min<std::size_t>(this->m_count, c_capacity));
+        }
+
+        [[nodiscard]] static constexpr std::size_t rank(const float p,
+            const std::size_t size) noexcept
+        {
+            return std::min(static_cast<std::size_t>(
+                p * static_cast<float>(size)), size - 1);
+        }
+
         eqx::lib::Timer m_timer;
         float m_fps;
         unsigned long long m_frames;
+        std::chrono::steady_clock::time_point m_last;
+        std::array<float, c_capacity> m_times;
+        unsigned long long m_count;
+        float m_median;
+        float m_hitch_factor;
+        unsigned long long m_hitches;
     };
 }
@@ -0,0 +1,12 @@
+#version 330 core
+
+out vec4 FragColor;
+
+in vec2 p_local;
+in vec4 p_color;
+
+void main()
+{
+    float falloff = clamp(1.0f - dot(p_local, p_local), 0.0f, 1.0f);
+    FragColor = p_color * falloff;
+}
@@ -0,0 +1,88 @@
+#version 330 core
+
+layout (location = 0) in vec2 i_position;
+layout (location = 1) in vec2 i_velocity;
+layout (location = 2) in vec3 i_state;
+
+const int c_max_styles = 8;
+const int c_max_emissions = 32;
+
+uniform float u_dt;
+uniform int u_seed;
+uniform int u_capacity;
+uniform int u_spawn_first;
+uniform int u_spawn_count;
+uniform int u_emissions;
+
+// x, y, radius, style
+uniform vec4 u_emission_origin[c_max_emissions];
+// direction, spread, speed min, speed max
+uniform vec4 u_emission_shape[c_max_emissions];
+// first past u_spawn_first, count, life min, life max
+uniform vec4 u_emission_range[c_max_emissions];
+// drag, acceleration x, acceleration y, unused
+uniform vec4 u_style_motion[c_max_styles];
+
+out vec2 o_position;
+out vec2 o_velocity;
+out vec3 o_state;
+
+uint hash(uint v)
+{
+    uint state = v * 747796405u + 2891336453u;
+    uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    return (word >> 22u) ^ word;
+}
+
+float random(inout uint state)
+{
+    state = hash(state);
+    return float(state >> 8u) / 16777216.0f;
+}
+
+void spawn(int slot, int emission)
+{
+    vec4 origin = u_emission_origin[emission];
+    vec4 shape = u_emission_shape[emission];
+    vec4 range = u_emission_range[emission];
+
+    uint state = hash(uint(slot) ^ hash(uint(u_seed)));
+    float angle = shape.x + (random(state) * 2.0f - 1.0f) * shape.y;
+    float speed = mix(shape.z, shape.w, random(state));
+    float radius = origin.z * sqrt(random(state));
+    float offset = random(state) * 6.28318530718f;
+
+    o_position = origin.xy + radius * vec2(cos(offset), sin(offset));
+    o_velocity = speed * vec2(cos(angle), sin(angle));
+    o_state = vec3(0.0f, mix(range.z, range.w, random(state)), origin.w);
+}
+
+void main()
+{
+    int slot = (gl_VertexID - u_spawn_first + u_capacity) % u_capacity;
+    if (slot < u_spawn_count)
+    {
+        for (int i = 0; i < u_emissions; ++i)
+        {
+            vec4 range = u_emission_range[i];
+            if (float(slot) >= range.x && float(slot) < range.x + range.y)
+            {
+                spawn(gl_VertexID, i);
+                return;
+            }
+        }
+    }
+
+    o_position = i_position;
+    o_velocity = i_velocity;
+    o_state = i_state;
+    if (i_state.x >= i_state.y)
+    {
+        return;
+    }
+
+    vec4 motion = u_style_motion[int(i_state.z)];
+    o_velocity = i_velocity * exp(-motion.x * u_dt) + motion.yz * u_dt;
+    o_position = i_position + o_velocity * u_dt;
+    o_state.x = i_state.x + u_dt;
+}
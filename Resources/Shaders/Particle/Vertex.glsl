@@ -0,0 +1,49 @@
+#version 330 core
+
+layout (location = 0) in vec2 i_position;
+layout (location = 1) in vec2 i_velocity;
+layout (location = 2) in vec3 i_state;
+
+const int c_max_styles = 8;
+
+uniform mat4 u_view;
+uniform mat4 u_proj;
+
+// Premultiplied colors over the particle's life.
+uniform vec4 u_style_color_start[c_max_styles];
+uniform vec4 u_style_color_end[c_max_styles];
+// size start, size end, stretch, unused
+uniform vec4 u_style_shape[c_max_styles];
+
+out vec2 p_local;
+out vec4 p_color;
+
+void main()
+{
+    vec2 corner = vec2(float(gl_VertexID & 1) * 2.0f - 1.0f,
+        float(gl_VertexID >> 1) * 2.0f - 1.0f);
+    p_local = corner;
+
+    // Dead particles collapse outside the clip volume.
+    if (i_state.x >= i_state.y)
+    {
+        p_color = vec4(0.0f);
+        gl_Position = vec4(2.0f, 2.0f, 2.0f, 1.0f);
+        return;
+    }
+
+    int style = int(i_state.z);
+    float t = i_state.x / i_state.y;
+    vec4 shape = u_style_shape[style];
+    float size = mix(shape.x, shape.y, t);
+
+    // Quads stretch along their velocity, stretch is in seconds of travel.
+    float speed = length(i_velocity);
+    vec2 axis = speed > 0.0001f ? i_velocity / speed : vec2(1.0f, 0.0f);
+    vec2 normal = vec2(-axis.y, axis.x);
+    vec2 world = i_position + axis * corner.x * (size + speed * shape.z)
+        + normal * corner.y * size;
+
+    p_color = mix(u_style_color_start[style], u_style_color_end[style], t);
+    gl_Position = u_proj * u_view * vec4(world, 0.0f, 1.0f);
+}
@@ -0,0 +1,35 @@
+#version 330 core
+
+layout (location = 0) in vec2 i_position;
+layout (location = 1) in vec2 i_half_extents;
+layout (location = 2) in vec2 i_rotation_layer;
+layout (location = 3) in vec4 i_uv;
+layout (location = 4) in vec4 i_tint;
+
+uniform mat4 u_view;
+uniform mat4 u_proj;
+
+out vec2 p_tex_coord;
+out vec4 p_tint;
+
+void main()
+{
+    vec2 corner = vec2(float(gl_VertexID & 1) * 2.0f - 1.0f,
+        float(gl_VertexID >> 1) * 2.0f - 1.0f);
+
+    float angle = i_rotation_layer.x * 6.28318530718f;
+    float c = cos(angle);
+    float s = sin(angle);
+    vec2 local = corner * i_half_extents;
+    vec2 world = i_position + vec2(local.x * c - local.y * s,
+        local.x * s + local.y * c);
+
+    p_tex_coord = vec2(mix(i_uv.x, i_uv.z, corner.x * 0.5f + 0.5f),
+        mix(i_uv.w, i_uv.y, corner.y * 0.5f + 0.5f));
+    p_tint = i_tint;
+    gl_Position = u_proj * u_view * vec4(world, 0.0f, 1.0f);
+    // Layers land strictly inside the clip volume, layer 0 included, so
+    // GL_LESS against a depth buffer cleared to 1.0 keeps every one.
+    float layer = round(i_rotation_layer.y * 65535.0f);
+    gl_Position.z = (1.0f - (2.0f * layer + 1.0f) / 65536.0f) * gl_Position.w;
+}
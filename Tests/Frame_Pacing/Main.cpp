@@ -0,0 +1,80 @@
+// Main.cpp
+
+import <Eqx/std.hpp>;
+import Eqx.Lib;
+import Eqx.OGL.Frame_Limiter;
+import Eqx.OGL.Window;
+
+using namespace std::literals;
+
+#ifdef EQX_SMOKE
+    constexpr auto c_smoke = true;
+#else
+    constexpr auto c_smoke = false;
+#endif // EQX_SMOKE
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
+{
+    std::format_to(std::ostream_iterator<char>(std::cout), "Start\n\n"sv);
+
+    eqx::ogl::init();
+
+    auto loc = eqx::lib::Point<float>{};
+
+    auto window = eqx::ogl::Window{ 1920, 1080,
+        "eqx::ogl --- Test Frame_Pacing"sv };
+
+    // Without vsync the limiter alone paces the frames, missed deadlines
+    // show up in the title.
+    window.set_present_mode(eqx::ogl::Window::Present_Mode::Immediate);
+    window.set_max_frames_in_flight(1);
+    auto frame_limiter = eqx::ogl::Frame_Limiter{ 144.0F };
+
+    auto frame_timer = eqx::ogl::Frame_Timer{};
+    while (!window.should_close())
+    {
+        window.clear();
+
+        loc = window.get_cursor_location();
+        window.set_name(std::format(
+            "eqx::ogl --- "sv
+            "Test Frame_Pacing --- "sv
+            "Location: ({}, {}) --- "sv
+            "Frames: {} --- "sv
+            "FPS: {} --- "sv
+            "Missed: {} --- "sv
+            "Hitches: {}"sv,
+            loc.get_x(), loc.get_y(), frame_timer.get_frames(),
+            frame_timer.get_fps(), frame_limiter.get_missed(),
+            frame_timer.get_hitches()));
+
+        if constexpr (c_smoke == true)
+        {
+            window.close();
+        }
+
+        frame_timer.update();
+        frame_limiter.wait();
+        window.swap();
+        window.poll();
+    }
+
+    const auto stats = frame_timer.get_stats();
+    std::format_to(std::ostream_iterator<char>(std::cout),
+        "p50: {:.3f}ms p95: {:.3f}ms p99: {:.3f}ms max: {:.3f}ms\n"sv,
+        stats.p50, stats.p95, stats.p99, stats.max);
+    const auto histogram = frame_timer.get_histogram();
+    for (auto i = std::size_t{ 0 }; i < std::ranges::size(histogram); ++i)
+    {
+        std::format_to(std::ostream_iterator<char>(std::cout),
+            "{:>3}ms: {}\n"sv,
+            static_cast<float>(i) * eqx::ogl::Frame_Timer::c_bucket_ms,
+            histogram[i]);
+    }
+
+    window.free();
+    eqx::ogl::free();
+
+    std::format_to(std::ostream_iterator<char>(std::cout), "\nEnd\n"sv);
+    return EXIT_SUCCESS;
+}
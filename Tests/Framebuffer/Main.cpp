@@ -0,0 +1,113 @@
+// Main.cpp
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glad/glad.hpp>;
+import Eqx.Lib;
+import Eqx.OGL.Framebuffer;
+import Eqx.OGL.Shader_Program;
+import Eqx.OGL.Vertex_Array;
+import Eqx.OGL.Window;
+
+using namespace std::literals;
+
+#ifdef EQX_SMOKE
+    constexpr auto c_smoke = true;
+#else
+    constexpr auto c_smoke = false;
+#endif // EQX_SMOKE
+
+[[nodiscard]] std::array<unsigned char, 4> pixel(
+    const std::span<const unsigned char> pixels, const int width,
+    const int x, const int y) noexcept
+{
+    const auto i = static_cast<std::size_t>((y * width + x) * 4);
+    return std::array<unsigned char, 4>{
+        pixels[i], pixels[i + 1], pixels[i + 2], pixels[i + 3] };
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
+{
+    std::format_to(std::ostream_iterator<char>(std::cout), "Start\n\n"sv);
+
+    constexpr auto frames = c_smoke ? 3 : 1'000;
+
+    eqx::ogl::init();
+
+    auto ok = true;
+    {
+        auto window = eqx::ogl::Window{ 640, 480,
+            "eqx::ogl --- Test Framebuffer"sv };
+        auto shader_program = eqx::ogl::Shader_Program::from_files(
+            "./Resources/Shaders/Quad/Vertex.glsl"sv,
+            "./Resources/Shaders/Quad/Fragment.glsl"sv);
+        auto vertex_array = eqx::ogl::Vertex_Array{
+            std::array<float, 18>{
+                0.0f, 0.6f, 1.0f, 0.0f, 0.0f, 1.0f,
+                -0.6f, -0.6f, 1.0f, 0.0f, 0.0f, 1.0f,
+                0.6f, -0.6f, 1.0f, 0.0f, 0.0f, 1.0f },
+            std::array<unsigned int, 2>{ 2u, 4u },
+            std::array<unsigned int, 3>{ 0u, 1u, 2u } };
+
+        // The scene goes into a 4x multisampled target that follows the
+        // window size and is resolved straight into the window.
+        constexpr auto desc = eqx::ogl::Render_Target_Desc{ 0, 0, GL_RGBA8,
+            GL_DEPTH24_STENCIL8, 4 };
+        auto pool = eqx::ogl::Render_Target_Pool{ window };
+        for (auto i = 0; i < frames && !window.should_close(); ++i)
+        {
+            pool.new_frame();
+            auto& target = pool.acquire(desc);
+
+            target.framebuffer.enable();
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            shader_program.enable();
+            vertex_array.enable();
+            eqx::ogl::draw(vertex_array.get_index_count());
+
+            target.framebuffer.blit(window);
+            target.framebuffer.disable(window);
+
+            if (i == frames - 1)
+            {
+                const auto [width, height] = window.get_framebuffer_size();
+                const auto pixels = window.read_pixels();
+                const auto center = pixel(pixels, width, width / 2,
+                    height / 2);
+                const auto corner = pixel(pixels, width, 0, 0);
+
+                std::format_to(std::ostream_iterator<char>(std::cout),
+                    "Targets: {} allocated, {} pooled, {} bytes\n"sv
+                    "Center: ({}, {}, {}, {})\n"sv
+                    "Corner: ({}, {}, {}, {})\n"sv,
+                    pool.get_allocations(), pool.get_count(),
+                    target.color.get_bytes() + target.depth.get_bytes(),
+                    center[0], center[1], center[2], center[3],
+                    corner[0], corner[1], corner[2], corner[3]);
+
+                ok = center == std::array<unsigned char, 4>{ 255, 0, 0, 255 }
+                    && corner[0] < 128 && corner[2] > 0
+                    && pool.get_allocations() == 1ull;
+            }
+
+            if (window.key_down(eqx::ogl::Window::Key::Escape))
+            {
+                window.close();
+            }
+
+            window.swap();
+            window.poll();
+        }
+    }
+
+    eqx::ogl::free();
+
+    if (!ok)
+    {
+        std::format_to(std::ostream_iterator<char>(std::cerr),
+            "Resolved frame or target reuse is not as expected\n"sv);
+        return EXIT_FAILURE;
+    }
+
+    std::format_to(std::ostream_iterator<char>(std::cout), "\nEnd\n"sv);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,101 @@
+// Main.cpp
+
+import <Eqx/std.hpp>;
+import Eqx.Lib;
+import Eqx.OGL.Window;
+import Eqx.OGL.Shader_Program;
+import Eqx.OGL.Vertex_Array;
+
+using namespace std::literals;
+
+#ifdef EQX_SMOKE
+    constexpr auto c_smoke = true;
+#else
+    constexpr auto c_smoke = false;
+#endif // EQX_SMOKE
+
+[[nodiscard]] std::array<unsigned char, 4> pixel(
+    const std::span<const unsigned char> pixels, const int width,
+    const int x, const int y) noexcept
+{
+    const auto i = static_cast<std::size_t>((y * width + x) * 4);
+    return std::array<unsigned char, 4>{
+        pixels[i], pixels[i + 1], pixels[i + 2], pixels[i + 3] };
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
+{
+    std::format_to(std::ostream_iterator<char>(std::cout), "Start\n\n"sv);
+
+    constexpr auto width = 320;
+    constexpr auto height = 240;
+    constexpr auto frames = c_smoke ? 1 : 1'000;
+
+    eqx::ogl::init(eqx::ogl::backend_from_env() == eqx::ogl::Backend::OSMesa
+        ? eqx::ogl::Backend::OSMesa
+        : eqx::ogl::Backend::Egl);
+
+    auto window = eqx::ogl::Window{ width, height,
+        "eqx::ogl --- Test Headless"sv };
+    auto shader_program = eqx::ogl::Shader_Program::from_files(
+        "./Resources/Shaders/Quad/Vertex.glsl"sv,
+        "./Resources/Shaders/Quad/Fragment.glsl"sv);
+    auto vertex_array = eqx::ogl::Vertex_Array{
+        std::array<float, 24>{
+            0.5f, 0.5f, 1.0f, 0.0f, 0.0f, 1.0f,
+            -0.5f, 0.5f, 1.0f, 0.0f, 0.0f, 1.0f,
+            0.5f, -0.5f, 1.0f, 0.0f, 0.0f, 1.0f,
+            -0.5f, -0.5f, 1.0f, 0.0f, 0.0f, 1.0f },
+        std::array<unsigned int, 2>{ 2u, 4u },
+        std::array<unsigned int, 6>{
+            0u, 1u, 2u,
+            1u, 3u, 2u }};
+
+    const auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < frames; ++i)
+    {
+        window.clear();
+
+        shader_program.enable();
+        vertex_array.enable();
+        eqx::ogl::draw(vertex_array.get_index_count());
+
+        window.swap();
+        window.poll();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const auto pixels = window.read_pixels();
+    const auto center = pixel(pixels, width, width / 2, height / 2);
+    const auto corner = pixel(pixels, width, 0, 0);
+
+    std::format_to(std::ostream_iterator<char>(std::cout),
+        "Backend: {}\n"sv
+        "Frames: {} in {:.3f}ms\n"sv
+        "Center: ({}, {}, {}, {})\n"sv
+        "Corner: ({}, {}, {}, {})\n"sv,
+        eqx::ogl::get_backend() == eqx::ogl::Backend::Egl
+            ? "EGL"sv : "OSMesa"sv,
+        frames,
+        std::chrono::duration<double, std::milli>(end - start).count(),
+        center[0], center[1], center[2], center[3],
+        corner[0], corner[1], corner[2], corner[3]);
+
+    const auto ok = center == std::array<unsigned char, 4>{ 255, 0, 0, 255 }
+        && corner[0] < 128 && corner[2] > 0;
+
+    shader_program.free();
+    vertex_array.free();
+    window.free();
+    eqx::ogl::free();
+
+    if (!ok)
+    {
+        std::format_to(std::ostream_iterator<char>(std::cerr),
+            "Headless framebuffer does not hold the expected frame\n"sv);
+        return EXIT_FAILURE;
+    }
+
+    std::format_to(std::ostream_iterator<char>(std::cout), "\nEnd\n"sv);
+    return EXIT_SUCCESS;
+}
@@ -13,6 +13,17 @@ using namespace std::literals;
     constexpr auto c_smoke = false;
 #endif // EQX_SMOKE
 
+[[nodiscard]] constexpr eqx::lib::Polygon<float, 4> lerp(
+    const eqx::lib::Polygon<float, 4>& p1,
+    const eqx::lib::Polygon<float, 4>& p2, const float t) noexcept
+{
+    return eqx::lib::Polygon<float, 4>{
+        eqx::lib::Point<float>::lerp(p1.get_data()[0], p2.get_data()[0], t),
+        eqx::lib::Point<float>::lerp(p1.get_data()[1], p2.get_data()[1], t),
+        eqx::lib::Point<float>::lerp(p1.get_data()[2], p2.get_data()[2], t),
+        eqx::lib::Point<float>::lerp(p1.get_data()[3], p2.get_data()[3], t) };
+}
+
 namespace Component
 {
     class Angular
@@ -460,10 +471,8 @@ public:
         m_shader_program(eqx::ogl::Shader_Program::from_files(
             "./Resources/Shaders/KGame/Vertex.glsl"sv,
             "./Resources/Shaders/KGame/Fragment.glsl"sv)),
-        m_vertex_array(
-            std::array<float, 16>{},
-            std::array<unsigned int, 2>{ 2u, 2u },
-            std::array<unsigned int, 6>{ 0u, 1u, 2u, 1u, 3u, 2u }),
+        m_batch(),
+        m_sampler(eqx::ogl::Sampler_State::linear()),
         m_sherman_turret_tex("./Resources/Textures/M4_Sherman_Turret.png"sv),
         m_sherman_hull_tex("./Resources/Textures/M4_Sherman_Hull.png"sv),
         m_panzer_turret_tex("./Resources/Textures/Panzer3_Turret.png"sv),
@@ -481,58 +490,51 @@ public:
         this->m_shader_program.activate_texture("u_tex0"sv, 0);
     }
 
-    inline void render(const Sim& sim) noexcept
+    inline void render(const Sim& previous, const Sim& sim,
+        const float alpha) noexcept
     {
-        this->set_vertex_array(sim.get_sherman_hull());
-        this->draw(this->m_sherman_hull_tex);
+        this->m_shader_program.enable();
+
+        this->m_batch.submit(lerp(previous.get_sherman_hull(),
+            sim.get_sherman_hull(), alpha),
+            this->m_sherman_hull_tex, this->m_sampler);
 
         if (sim.get_shell().has_value())
         {
-            this->set_vertex_array(sim.get_shell().value());
-            this->draw(this->m_shell_tex);
+            this->m_batch.submit(previous.get_shell().has_value()
+                ? lerp(previous.get_shell().value(), sim.get_shell().value(),
+                    alpha)
+                : sim.get_shell().value(),
+                this->m_shell_tex, this->m_sampler);
         }
 
-        this->set_vertex_array(sim.get_sherman_turret());
-        this->draw(this->m_sherman_turret_tex);
+        this->m_batch.submit(lerp(previous.get_sherman_turret(),
+            sim.get_sherman_turret(), alpha),
+            this->m_sherman_turret_tex, this->m_sampler);
 
+        const auto panzer_hull = lerp(previous.get_panzer_hull(),
+            sim.get_panzer_hull(), alpha);
         if (sim.panzer_alive())
         {
-            this->set_vertex_array(sim.get_panzer_hull());
-            this->draw(this->m_panzer_hull_tex);
-
-            this->set_vertex_array(sim.get_panzer_turret());
-            this->draw(this->m_panzer_turret_tex);
+            this->m_batch.submit(panzer_hull, this->m_panzer_hull_tex,
+                this->m_sampler);
+            this->m_batch.submit(lerp(previous.get_panzer_turret(),
+                sim.get_panzer_turret(), alpha),
+                this->m_panzer_turret_tex, this->m_sampler);
         }
         else
         {
-            this->set_vertex_array(sim.get_panzer_hull());
-            this->draw(this->m_panzer_destroyed_tex);
+            this->m_batch.submit(panzer_hull, this->m_panzer_destroyed_tex,
+                this->m_sampler);
         }
-    }
-
-private:
-    inline void draw(const eqx::ogl::Texture& tex) const noexcept
-    {
-        this->m_shader_program.enable();
-        this->m_vertex_array.enable();
-        tex.enable(0);
-        eqx::ogl::draw(this->m_vertex_array.get_index_count());
-    }
 
-    inline void set_vertex_array(
-        const eqx::lib::Polygon<float, 4>& geometry) noexcept
-    {
-        this->m_vertex_array.set_vertex_buffer(
-            std::array<float, 16>{
-                geometry.get_data()[0].get_x(), geometry.get_data()[0].get_y(), 1.0F, 0.0F,
-                geometry.get_data()[1].get_x(), geometry.get_data()[1].get_y(), 0.0F, 0.0F,
-                geometry.get_data()[3].get_x(), geometry.get_data()[3].get_y(), 1.0F, 1.0F,
-                geometry.get_data()[2].get_x(), geometry.get_data()[2].get_y(), 0.0F, 1.0F },
-            std::array<unsigned int, 2>{ 2U, 2U });
+        this->m_batch.flush();
     }
 
+private:
     eqx::ogl::Shader_Program m_shader_program;
-    eqx::ogl::Vertex_Array m_vertex_array;
+    eqx::ogl::Sprite_Batch m_batch;
+    eqx::ogl::Sampler m_sampler;
     eqx::ogl::Texture m_sherman_turret_tex;
     eqx::ogl::Texture m_sherman_hull_tex;
     eqx::ogl::Texture m_panzer_turret_tex;
@@ -562,15 +564,12 @@ public:
     {
         auto loc = eqx::lib::Point<float>{};
         auto frame_timer = eqx::ogl::Frame_Timer{};
-        auto sim_timer = eqx::lib::Timer{};
-        auto seconds = 0.0F;
-        constexpr auto tick = 1.0F / 60.0F;
+        auto loop = eqx::ogl::Loop{ 1.0F / 60.0F };
+        auto previous = this->m_sim;
 
-        sim_timer.start();
         while (!this->m_window.should_close())
         {
-            seconds += sim_timer.readf();
-            sim_timer.start();
+            const auto steps = loop.advance();
 
             this->m_window.clear();
 
@@ -584,15 +583,23 @@ public:
                 loc.get_x(), loc.get_y(), frame_timer.get_frames(),
                 frame_timer.get_fps()));
 
-            this->handle_input();
+            {
+                const auto zone = eqx::ogl::Zone{ "KGame::handle_input"sv };
+                this->handle_input();
+            }
 
-            while (seconds > tick)
+            for (auto i = 0; i < steps; ++i)
             {
-                this->m_sim.update(tick);
-                seconds -= tick;
+                const auto zone = eqx::ogl::Zone{ "Sim::update"sv };
+                previous = this->m_sim;
+                this->m_sim.update(loop.get_tick());
             }
 
-            this->m_renderer.render(this->m_sim);
+            {
+                const auto zone = eqx::ogl::Zone{ "Renderer::render"sv };
+                this->m_renderer.render(previous, this->m_sim,
+                    loop.get_alpha());
+            }
 
             if (this->m_window.key_down(eqx::ogl::Window::Key::Escape))
             {
@@ -692,6 +699,9 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
 
     eqx::ogl::init();
 
+    const auto trace = eqx::ogl::Trace::enable_from_env();
+    eqx::ogl::Trace::set_thread_name("Main"sv);
+
     {
         auto kgame = KGame{};
         kgame.run();
@@ -699,6 +709,12 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
 
     eqx::ogl::free();
 
+    if (trace.has_value() && !eqx::ogl::Trace::write(trace.value()))
+    {
+        std::format_to(std::ostream_iterator<char>(std::cerr),
+            "Could not write trace to {}\n"sv, trace->string());
+    }
+
     std::format_to(std::ostream_iterator<char>(std::cout), "\nEnd\n"sv);
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,197 @@
+// Main.cpp
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glm/glm.hpp>;
+import Eqx.Lib;
+import Eqx.OGL;
+
+using namespace std::literals;
+
+#ifdef EQX_SMOKE
+    constexpr auto c_smoke = true;
+#else
+    constexpr auto c_smoke = false;
+#endif // EQX_SMOKE
+
+// The pattern covers the whole world, every view below stays inside it.
+constexpr auto c_world = eqx::ogl::Aabb{ 0.0F, 0.0F, 800.0F, 600.0F };
+
+struct Step
+{
+    eqx::ogl::Aabb view;
+    bool invalidate;
+    bool redraw;
+};
+
+/*
+ * Pans that stay within the cache's margin, a zoom, a pan at that zoom and
+ * an invalidate. Wrapping around zooms back out, so the script redraws
+ * exactly where it says on every pass.
+ */
+constexpr auto c_script = std::array<Step, 7>{
+    Step{ eqx::ogl::Aabb{ 80.0F, 60.0F, 720.0F, 540.0F }, false, true },
+    Step{ eqx::ogl::Aabb{ 96.0F, 68.0F, 736.0F, 548.0F }, false, false },
+    Step{ eqx::ogl::Aabb{ 56.0F, 80.0F, 696.0F, 560.0F }, false, false },
+    Step{ eqx::ogl::Aabb{ 120.0F, 30.0F, 760.0F, 510.0F }, false, false },
+    Step{ eqx::ogl::Aabb{ 160.0F, 120.0F, 640.0F, 480.0F }, false, true },
+    Step{ eqx::ogl::Aabb{ 172.0F, 114.0F, 652.0F, 474.0F }, false, false },
+    Step{ eqx::ogl::Aabb{ 172.0F, 114.0F, 652.0F, 474.0F }, true, true } };
+
+[[nodiscard]] constexpr eqx::lib::Polygon<float, 4> to_polygon(
+    const eqx::ogl::Aabb& aabb) noexcept
+{
+    return eqx::lib::Polygon<float, 4>{
+        eqx::lib::Point<float>{ aabb.right, aabb.top },
+        eqx::lib::Point<float>{ aabb.left, aabb.top },
+        eqx::lib::Point<float>{ aabb.left, aabb.bottom },
+        eqx::lib::Point<float>{ aabb.right, aabb.bottom } };
+}
+
+// An 8x8 grid of distinct opaque colours.
+[[nodiscard]] std::vector<unsigned char> make_pattern() noexcept
+{
+    auto texels = std::vector<unsigned char>{};
+    texels.reserve(8ull * 8ull * 4ull);
+    for (auto y = 0; y < 8; ++y)
+    {
+        for (auto x = 0; x < 8; ++x)
+        {
+            texels.push_back(static_cast<unsigned char>(x * 32 + 16));
+            texels.push_back(static_cast<unsigned char>(y * 32 + 16));
+            texels.push_back(static_cast<unsigned char>((x ^ y) * 32 + 16));
+            texels.push_back(255u);
+        }
+    }
+
+    return texels;
+}
+
+// Counts pixels where any channel is further apart than a rounding error.
+[[nodiscard]] std::size_t count_mismatches(
+    const std::span<const unsigned char> a,
+    const std::span<const unsigned char> b) noexcept
+{
+    auto mismatches = std::size_t{ 0 };
+    for (auto i = std::size_t{ 0 }; i + 3 < std::ranges::size(a); i += 4)
+    {
+        for (auto channel = std::size_t{ 0 }; channel < 4; ++channel)
+        {
+            if (std::abs(static_cast<int>(a[i + channel])
+                - static_cast<int>(b[i + channel])) > 2)
+            {
+                ++mismatches;
+                break;
+            }
+        }
+    }
+
+    return mismatches;
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
+{
+    std::format_to(std::ostream_iterator<char>(std::cout), "Start\n\n"sv);
+
+    constexpr auto frames =
+        c_smoke ? static_cast<int>(std::ranges::size(c_script)) : 1'000;
+
+    eqx::ogl::init();
+
+    auto ok = true;
+    {
+        auto window = eqx::ogl::Window{ 640, 480,
+            "eqx::ogl --- Test Layer_Cache"sv };
+        auto shader_program = eqx::ogl::Shader_Program::from_files(
+            "./Resources/Shaders/MGame/Vertex.glsl"sv,
+            "./Resources/Shaders/MGame/Fragment.glsl"sv);
+        shader_program.set_mat4("u_view"sv, glm::mat4{ 1.0f });
+        shader_program.activate_texture("u_tex0"sv, 0);
+
+        const auto texels = make_pattern();
+        const auto pattern = eqx::ogl::Texture{
+            eqx::ogl::Texel_View{ texels, 8, 8, 4 } };
+        auto samplers = eqx::ogl::Sampler_Cache{};
+        const auto& nearest =
+            samplers.get(eqx::ogl::Sampler_State::nearest());
+        auto batch = eqx::ogl::Sprite_Batch{};
+        auto cache = eqx::ogl::Layer_Cache{ window };
+
+        const auto draw = [&](const eqx::ogl::Aabb& area,
+            const eqx::ogl::Texture& texture,
+            const eqx::ogl::Aabb& quad,
+            const eqx::ogl::Uv_Rect& uv) noexcept
+        {
+            shader_program.set_mat4("u_proj"sv, glm::ortho(area.left,
+                area.right, area.bottom, area.top));
+            shader_program.enable();
+            batch.submit(to_polygon(quad), texture, nearest, uv);
+            batch.flush();
+        };
+
+        auto worst = std::size_t{ 0 };
+        for (auto i = 0; i < frames && !window.should_close(); ++i)
+        {
+            const auto& step = c_script[static_cast<std::size_t>(i)
+                % std::ranges::size(c_script)];
+
+            if (step.invalidate)
+            {
+                cache.invalidate();
+            }
+
+            const auto renders = cache.get_renders();
+            const auto redrawn = cache.update(step.view,
+                [&](const eqx::ogl::Aabb& region) noexcept
+                {
+                    draw(region, pattern, c_world,
+                        eqx::ogl::Uv_Rect::full());
+                });
+            ok = ok && redrawn == step.redraw && cache.get_renders()
+                == renders + (step.redraw ? 1ull : 0ull);
+
+            // The cached quad has to look like the pattern drawn directly.
+            window.clear();
+            draw(step.view, cache.get_texture(), step.view,
+                cache.get_uv(step.view));
+            const auto cached = window.read_pixels();
+
+            window.clear();
+            draw(step.view, pattern, c_world, eqx::ogl::Uv_Rect::full());
+            const auto direct = window.read_pixels();
+
+            // Unless the view is aligned with the cached texels, a pixel
+            // next to a pattern edge may sample the texel across it, so
+            // each of the 7 edges either way may cost a row or column.
+            const auto [width, height] = window.get_framebuffer_size();
+            const auto mismatches = count_mismatches(cached, direct);
+            worst = std::max(worst, mismatches);
+            ok = ok && !std::ranges::empty(cached) && mismatches
+                <= static_cast<std::size_t>(7 * (width + height));
+
+            if (window.key_down(eqx::ogl::Window::Key::Escape))
+            {
+                window.close();
+            }
+
+            window.swap();
+            window.poll();
+        }
+
+        std::format_to(std::ostream_iterator<char>(std::cout),
+            "Renders: {}\n"sv
+            "Worst mismatch: {} pixels\n"sv,
+            cache.get_renders(), worst);
+    }
+
+    eqx::ogl::free();
+
+    if (!ok)
+    {
+        std::format_to(std::ostream_iterator<char>(std::cerr),
+            "Layer_Cache redrew or presented the layer unexpectedly\n"sv);
+        return EXIT_FAILURE;
+    }
+
+    std::format_to(std::ostream_iterator<char>(std::cout), "\nEnd\n"sv);
+    return EXIT_SUCCESS;
+}
@@ -13,6 +13,11 @@ using namespace std::literals;
     constexpr auto c_smoke = false;
 #endif // EQX_SMOKE
 
+// Particle_System style slots used by the effects.
+constexpr auto c_flash_style = 0u;
+constexpr auto c_smoke_style = 1u;
+constexpr auto c_trail_style = 2u;
+
 [[nodiscard]] constexpr bool near(const eqx::lib::Point<float>& p1,
     const eqx::lib::Point<float>& p2) noexcept
 {
@@ -31,6 +36,39 @@ using namespace std::literals;
     return std::make_pair(width, height);
 }
 
+[[nodiscard]] constexpr eqx::lib::Polygon<float, 4> lerp(
+    const eqx::lib::Polygon<float, 4>& p1,
+    const eqx::lib::Polygon<float, 4>& p2, const float t) noexcept
+{
+    return eqx::lib::Polygon<float, 4>{
+        eqx::lib::Point<float>::lerp(p1.get_data()[0], p2.get_data()[0], t),
+        eqx::lib::Point<float>::lerp(p1.get_data()[1], p2.get_data()[1], t),
+        eqx::lib::Point<float>::lerp(p1.get_data()[2], p2.get_data()[2], t),
+        eqx::lib::Point<float>::lerp(p1.get_data()[3], p2.get_data()[3], t) };
+}
+
+// Corners in the same order as Polygon::rectangle.
+[[nodiscard]] constexpr eqx::lib::Polygon<float, 4> to_polygon(
+    const eqx::ogl::Aabb& aabb) noexcept
+{
+    return eqx::lib::Polygon<float, 4>{
+        eqx::lib::Point<float>{ aabb.right, aabb.top },
+        eqx::lib::Point<float>{ aabb.left, aabb.top },
+        eqx::lib::Point<float>{ aabb.left, aabb.bottom },
+        eqx::lib::Point<float>{ aabb.right, aabb.bottom } };
+}
+
+[[nodiscard]] constexpr bool same(const eqx::lib::Polygon<float, 4>& p1,
+    const eqx::lib::Polygon<float, 4>& p2) noexcept
+{
+    return std::ranges::equal(p1.get_data(), p2.get_data(),
+        [](const eqx::lib::Point<float>& a,
+            const eqx::lib::Point<float>& b) noexcept
+        {
+            return a.get_x() == b.get_x() && a.get_y() == b.get_y();
+        });
+}
+
 class Shell
 {
 public:
@@ -76,6 +114,14 @@ private:
     eqx::lib::Polygon<float, 4> m_geometry;
 };
 
+[[nodiscard]] constexpr eqx::lib::Polygon<float, 4> lerp(
+    const std::optional<Shell>& s1, const Shell& s2, const float t) noexcept
+{
+    return s1.has_value()
+        ? lerp(s1->get_geometry(), s2.get_geometry(), t)
+        : s2.get_geometry();
+}
+
 class Tank
 {
 public:
@@ -341,6 +387,28 @@ public:
         this->update_view(dt);
     }
 
+    /*
+     * Whether the last update() left everything drawn where it was. Only
+     * input changes what update() does, so until then every later one is
+     * a no-op too and the loop may stop ticking.
+     */
+    [[nodiscard]] constexpr bool settled(const Sim& previous) const noexcept
+    {
+        return !this->m_sherman_shell.has_value()
+            && !this->m_panzer_shell.has_value()
+            && !previous.m_sherman_shell.has_value()
+            && !previous.m_panzer_shell.has_value()
+            && same(this->m_sherman.get_hull_geometry(),
+                previous.m_sherman.get_hull_geometry())
+            && same(this->m_sherman.get_turret_geometry(),
+                previous.m_sherman.get_turret_geometry())
+            && same(this->m_panzer.get_hull_geometry(),
+                previous.m_panzer.get_hull_geometry())
+            && same(this->m_panzer.get_turret_geometry(),
+                previous.m_panzer.get_turret_geometry())
+            && same(this->view(), previous.view());
+    }
+
     constexpr void update_view(const float dt) noexcept
     {
         constexpr auto speed = 200.0F;
@@ -467,6 +535,62 @@ private:
     std::optional<Tank*> m_selected_tank;
 };
 
+// Direction a shell travels in, radians.
+[[nodiscard]] inline float heading(const Shell& shell) noexcept
+{
+    const auto& geometry = shell.get_geometry();
+    const auto normal = eqx::lib::Point<float>::translate(
+        eqx::lib::Point<float>::midpoint(geometry.get_data()[0],
+            geometry.get_data()[1]),
+        eqx::lib::Point<float>::negate(geometry.center()));
+    return std::atan2(normal.get_y(), normal.get_x());
+}
+
+/*
+ * Effects for the tick from previous to sim: a muzzle flash and smoke when
+ * a shell is fired, a trail while it flies and a burst where it leaves.
+ * The particles only live on the GPU, this just queues emissions.
+ */
+inline void emit_effects(const Sim& previous, const Sim& sim,
+    eqx::ogl::Particle_System& particles) noexcept
+{
+    constexpr auto pi = std::numbers::pi_v<float>;
+
+    const auto shell = [&particles](const std::optional<Shell>& before,
+        const std::optional<Shell>& after) noexcept
+    {
+        if (after.has_value())
+        {
+            const auto center = after->get_geometry().center();
+            const auto direction = heading(after.value());
+            if (!before.has_value())
+            {
+                particles.emit(eqx::ogl::Particle_Emission{ center,
+                    direction, 0.35F, 100.0F, 300.0F, 0.08F, 0.2F, 2.0F,
+                    c_flash_style, 40u });
+                particles.emit(eqx::ogl::Particle_Emission{ center,
+                    direction, pi, 10.0F, 60.0F, 1.0F, 2.5F, 8.0F,
+                    c_smoke_style, 60u });
+            }
+
+            particles.emit(eqx::ogl::Particle_Emission{ center,
+                direction + pi, 0.3F, 5.0F, 20.0F, 0.3F, 0.6F, 1.0F,
+                c_trail_style, 6u });
+        }
+        else if (before.has_value())
+        {
+            const auto center = before->get_geometry().center();
+            particles.emit(eqx::ogl::Particle_Emission{ center, 0.0F, pi,
+                50.0F, 200.0F, 0.1F, 0.3F, 2.0F, c_flash_style, 30u });
+            particles.emit(eqx::ogl::Particle_Emission{ center, 0.0F, pi,
+                10.0F, 40.0F, 1.0F, 2.0F, 6.0F, c_smoke_style, 40u });
+        }
+    };
+
+    shell(previous.get_sherman_shell(), sim.get_sherman_shell());
+    shell(previous.get_panzer_shell(), sim.get_panzer_shell());
+}
+
 class Renderer
 {
 public:
@@ -476,16 +600,23 @@ public:
     Renderer& operator= (Renderer&&) = default;
     ~Renderer() = default;
 
-    explicit inline Renderer() noexcept
+    explicit inline Renderer(const eqx::ogl::Window& window) noexcept
         :
         m_shader_program(eqx::ogl::Shader_Program::from_files(
             "./Resources/Shaders/MGame/Vertex.glsl"sv,
             "./Resources/Shaders/MGame/Fragment.glsl"sv)),
-        m_vertex_array(
-            std::array<float, 16>{},
-            std::array<unsigned int, 2>{ 2u, 2u },
-            std::array<unsigned int, 6>{ 0u, 1u, 2u, 1u, 3u, 2u }),
-        m_map_tex("./Resources/Maps/MGame.png"sv),
+        m_batch(),
+        m_queue(),
+        m_grid(),
+        m_handles(),
+        m_visible(),
+        m_samplers(),
+        m_background(window),
+        m_map_pack("./Resources/MGame.pack"sv),
+        m_map(m_map_pack, "Maps/MGame.png"sv),
+        m_busy(false),
+        m_particles(16'384ull),
+        m_last_frame(std::chrono::steady_clock::now()),
         m_panzer3_hull_tex("./Resources/Textures/Panzer3_Hull.png"sv),
         m_panzer3_turret_tex("./Resources/Textures/Panzer3_Turret.png"sv),
         m_m4_sherman_hull_tex("./Resources/Textures/M4_Sherman_Hull.png"sv),
@@ -500,36 +631,182 @@ public:
         this->m_shader_program.set_mat4("u_proj"sv, proj);
 
         this->m_shader_program.activate_texture("u_tex0"sv, 0);
+
+        this->m_particles.get_draw_program().set_mat4("u_proj"sv, proj);
+        this->m_particles.set_style(c_flash_style, eqx::ogl::Particle_Style{
+            glm::vec4(1.0F, 0.7F, 0.3F, 0.0F),
+            glm::vec4(0.4F, 0.1F, 0.0F, 0.0F),
+            3.0F, 6.0F, 0.03F, 6.0F, eqx::lib::Point<float>{} });
+        this->m_particles.set_style(c_smoke_style, eqx::ogl::Particle_Style{
+            glm::vec4(0.18F, 0.18F, 0.18F, 0.5F),
+            glm::vec4(0.0F, 0.0F, 0.0F, 0.0F),
+            4.0F, 20.0F, 0.0F, 1.5F, eqx::lib::Point<float>{ 5.0F, 3.0F } });
+        this->m_particles.set_style(c_trail_style, eqx::ogl::Particle_Style{
+            glm::vec4(0.12F, 0.12F, 0.12F, 0.35F),
+            glm::vec4(0.0F, 0.0F, 0.0F, 0.0F),
+            1.5F, 4.0F, 0.0F, 2.0F, eqx::lib::Point<float>{} });
     }
 
-    inline void render(const Sim& sim) noexcept
+    inline void render(const Sim& previous, const Sim& sim,
+        const float alpha) noexcept
     {
-        this->set_view(sim.view());
-
-        this->set_vertex_array(sim.get_map());
-        this->draw(this->m_map_tex);
-
+        const auto view = lerp(previous.view(), sim.view(), alpha);
+        this->set_view(view);
+
+        this->m_batch.reset_stats();
+
+        // The map is drawn into the background cache only when the view
+        // zooms or pans off the cached area, or while finer tiles are still
+        // streaming in, every other frame it is a single quad.
+        const auto& nearest =
+            this->m_samplers.get(eqx::ogl::Sampler_State::nearest());
+        const auto bounds = eqx::ogl::Aabb::from(view);
+        if (this->m_map.get_pending_count() > 0ull)
+        {
+            this->m_background.invalidate();
+        }
+        this->m_background.update(bounds,
+            [this, &sim, &nearest, &bounds](const eqx::ogl::Aabb& region)
+                noexcept
+            {
+                // The region fills the cache's texture, which is what sets
+                // the density tiles are chosen for.
+                const auto area = to_polygon(region);
+                this->set_view(area);
+                this->m_map.update(sim.get_map(), area, static_cast<float>(
+                    this->m_background.get_texture_width()));
+                for (const auto& tile : this->m_map.get_tiles())
+                {
+                    this->submit(0u, tile.geometry, *tile.texture, nearest);
+                }
+                this->m_queue.execute(this->m_batch);
+            });
+        this->set_view(view);
+
+        // Layers keep the map under shells, shells under hulls and hulls
+        // under turrets, the queue groups by texture within each.
+        this->submit(0u, view, this->m_background.get_texture(), nearest,
+            this->m_background.get_uv(bounds));
+
+        auto units = std::array<std::optional<Unit>, 6>{};
         if (sim.get_panzer_shell().has_value())
         {
-            this->set_vertex_array(sim.get_panzer_shell()->get_geometry());
-            this->draw(this->m_tank_shell_tex);
+            units[0].emplace(1u, lerp(previous.get_panzer_shell(),
+                sim.get_panzer_shell().value(), alpha),
+                &this->m_tank_shell_tex);
         }
 
         if (sim.get_sherman_shell().has_value())
         {
-            this->set_vertex_array(sim.get_sherman_shell()->get_geometry());
-            this->draw(this->m_tank_shell_tex);
+            units[1].emplace(1u, lerp(previous.get_sherman_shell(),
+                sim.get_sherman_shell().value(), alpha),
+                &this->m_tank_shell_tex);
+        }
+
+        units[2].emplace(2u, lerp(previous.get_panzer().get_hull_geometry(),
+            sim.get_panzer().get_hull_geometry(), alpha),
+            &this->m_panzer3_hull_tex);
+        units[3].emplace(3u, lerp(
+            previous.get_panzer().get_turret_geometry(),
+            sim.get_panzer().get_turret_geometry(), alpha),
+            &this->m_panzer3_turret_tex);
+
+        units[4].emplace(2u, lerp(
+            previous.get_sherman().get_hull_geometry(),
+            sim.get_sherman().get_hull_geometry(), alpha),
+            &this->m_m4_sherman_hull_tex);
+        units[5].emplace(3u, lerp(
+            previous.get_sherman().get_turret_geometry(),
+            sim.get_sherman().get_turret_geometry(), alpha),
+            &this->m_m4_sherman_turret_tex);
+
+        // Units only reach the queue when the grid finds them in view, the
+        // map is already culled tile by tile.
+        this->cull(units, view);
+        for (const auto handle : this->m_visible)
+        {
+            const auto slot = static_cast<std::size_t>(std::ranges::distance(
+                std::ranges::begin(this->m_handles),
+                std::ranges::find(this->m_handles, handle)));
+            const auto& unit = units[slot].value();
+            this->submit(unit.layer, unit.geometry, *unit.texture);
+        }
+
+        {
+            const auto scope = eqx::ogl::Gpu_Scope{ "sprites"sv };
+            this->m_queue.execute(this->m_batch);
+        }
+
+        // Particles advance by wall time, a long gap since the last frame
+        // only means nothing was alive to move.
+        {
+            const auto scope = eqx::ogl::Gpu_Scope{ "particles"sv };
+            const auto now = std::chrono::steady_clock::now();
+            this->m_particles.update(std::min(std::chrono::duration<float>(
+                now - this->m_last_frame).count(), 0.1F));
+            this->m_last_frame = now;
+
+            eqx::ogl::blend_premultiplied(true);
+            this->m_particles.draw();
+            eqx::ogl::blend_premultiplied(false);
         }
 
-        this->set_vertex_array(sim.get_panzer().get_hull_geometry());
-        this->draw(this->m_panzer3_hull_tex);
-        this->set_vertex_array(sim.get_panzer().get_turret_geometry());
-        this->draw(this->m_panzer3_turret_tex);
+        this->m_busy.store(this->m_map.get_pending_count() > 0ull,
+            std::memory_order_relaxed);
+    }
+
+    // Finer map tiles are still streaming in or particles are alive, more
+    // frames will differ.
+    [[nodiscard]] inline bool busy() const noexcept
+    {
+        return this->m_busy.load(std::memory_order_relaxed)
+            || this->m_particles.active();
+    }
+
+    // Emissions may be queued from the sim thread.
+    [[nodiscard]] inline eqx::ogl::Particle_System& get_particles() noexcept
+    {
+        return this->m_particles;
+    }
+
+    [[nodiscard]] inline const eqx::ogl::Particle_System&
+        get_particles() const noexcept
+    {
+        return this->m_particles;
+    }
+
+    [[nodiscard]] inline const eqx::ogl::Render_Queue&
+        get_queue() const noexcept
+    {
+        return this->m_queue;
+    }
+
+    // False when the map pack is missing or corrupt.
+    [[nodiscard]] inline bool has_map() const noexcept
+    {
+        return this->m_map.valid();
+    }
+
+    [[nodiscard]] inline std::size_t get_visible() const noexcept
+    {
+        return std::ranges::size(this->m_visible);
+    }
 
-        this->set_vertex_array(sim.get_sherman().get_hull_geometry());
-        this->draw(this->m_m4_sherman_hull_tex);
-        this->set_vertex_array(sim.get_sherman().get_turret_geometry());
-        this->draw(this->m_m4_sherman_turret_tex);
+    [[nodiscard]] inline std::size_t get_units() const noexcept
+    {
+        return this->m_grid.get_size();
+    }
+
+    [[nodiscard]] inline const eqx::ogl::Sprite_Batch&
+        get_batch() const noexcept
+    {
+        return this->m_batch;
+    }
+
+    [[nodiscard]] inline const eqx::ogl::Layer_Cache&
+        get_background() const noexcept
+    {
+        return this->m_background;
     }
 
     inline void set_view(const eqx::lib::Polygon<float, 4>& view) noexcept
@@ -545,32 +822,79 @@ public:
         uview = glm::translate(uview, glm::vec3(
             -view.get_data()[1].get_x(), -view.get_data()[1].get_y(), 0.0F));
         this->m_shader_program.set_mat4("u_view"sv, uview);
+        this->m_particles.get_draw_program().set_mat4("u_view"sv, uview);
     }
 
 private:
-    inline void draw(const eqx::ogl::Texture& tex) const noexcept
+    struct Unit
+    {
+        std::uint8_t layer;
+        eqx::lib::Polygon<float, 4> geometry;
+        const eqx::ogl::Texture* texture;
+    };
+
+    inline void cull(const std::array<std::optional<Unit>, 6>& units,
+        const eqx::lib::Polygon<float, 4>& view) noexcept
     {
-        this->m_shader_program.enable();
-        this->m_vertex_array.enable();
-        tex.enable(0);
-        eqx::ogl::draw(this->m_vertex_array.get_index_count());
+        for (auto i = std::size_t{ 0 }; i < std::ranges::size(units); ++i)
+        {
+            auto& handle = this->m_handles[i];
+            if (!units[i].has_value())
+            {
+                if (handle.has_value())
+                {
+                    this->m_grid.remove(handle.value());
+                    handle.reset();
+                }
+                continue;
+            }
+
+            const auto bounds = eqx::ogl::Aabb::from(units[i]->geometry);
+            if (handle.has_value())
+            {
+                this->m_grid.update(handle.value(), bounds);
+            }
+            else
+            {
+                handle = this->m_grid.insert(bounds);
+            }
+        }
+
+        this->m_visible.clear();
+        this->m_grid.query(eqx::ogl::Aabb::from(view), this->m_visible);
     }
 
-    inline void set_vertex_array(
-        const eqx::lib::Polygon<float, 4>& geometry) noexcept
+    inline void submit(const std::uint8_t layer,
+        const eqx::lib::Polygon<float, 4>& quad,
+        const eqx::ogl::Texture& tex,
+        const eqx::ogl::Sampler& sampler,
+        const eqx::ogl::Uv_Rect& uv = eqx::ogl::Uv_Rect::full()) noexcept
     {
-        this->m_vertex_array.set_vertex_buffer(
-            std::array<float, 16>{
-                geometry.get_data()[0].get_x(), geometry.get_data()[0].get_y(), 1.0F, 0.0F,
-                geometry.get_data()[1].get_x(), geometry.get_data()[1].get_y(), 0.0F, 0.0F,
-                geometry.get_data()[3].get_x(), geometry.get_data()[3].get_y(), 1.0F, 1.0F,
-                geometry.get_data()[2].get_x(), geometry.get_data()[2].get_y(), 0.0F, 1.0F },
-            std::array<unsigned int, 2>{ 2U, 2U });
+        this->m_queue.submit(layer, false, 0.0F, this->m_shader_program,
+            tex, sampler, quad, uv);
+    }
+
+    inline void submit(const std::uint8_t layer,
+        const eqx::lib::Polygon<float, 4>& quad,
+        const eqx::ogl::Texture& tex) noexcept
+    {
+        this->submit(layer, quad, tex,
+            this->m_samplers.get(eqx::ogl::Sampler_State::linear()));
     }
 
     eqx::ogl::Shader_Program m_shader_program;
-    eqx::ogl::Vertex_Array m_vertex_array;
-    eqx::ogl::Texture m_map_tex;
+    eqx::ogl::Sprite_Batch m_batch;
+    eqx::ogl::Render_Queue m_queue;
+    eqx::ogl::Spatial_Grid m_grid;
+    std::array<std::optional<eqx::ogl::Spatial_Grid::Handle>, 6> m_handles;
+    std::vector<eqx::ogl::Spatial_Grid::Handle> m_visible;
+    eqx::ogl::Sampler_Cache m_samplers;
+    eqx::ogl::Layer_Cache m_background;
+    eqx::ogl::Pack m_map_pack;
+    eqx::ogl::Tiled_Texture m_map;
+    std::atomic<bool> m_busy;
+    eqx::ogl::Particle_System m_particles;
+    std::chrono::steady_clock::time_point m_last_frame;
     eqx::ogl::Texture m_panzer3_hull_tex;
     eqx::ogl::Texture m_panzer3_turret_tex;
     eqx::ogl::Texture m_m4_sherman_hull_tex;
@@ -578,6 +902,13 @@ private:
     eqx::ogl::Texture m_tank_shell_tex;
 };
 
+struct Frame
+{
+    Sim previous{};
+    Sim current{};
+    float alpha{};
+};
+
 class MGame
 {
 public:
@@ -591,25 +922,81 @@ public:
         :
         m_window(1920, 1080, "eqx::ogl --- Test MGame"sv),
         m_sim(),
-        m_renderer()
+        m_renderer(m_window),
+        m_recorder(),
+        m_player(),
+        m_continuous(false)
     {
     }
 
+    inline void record(const std::filesystem::path& path) noexcept
+    {
+        this->m_recorder.emplace(path, c_tick);
+    }
+
+    // False, and nothing will replay, when the file is not a recording.
+    [[nodiscard]] inline bool replay(const std::filesystem::path& path) noexcept
+    {
+        this->m_player.emplace(path);
+        if (!this->m_player->valid())
+        {
+            this->m_player.reset();
+            return false;
+        }
+
+        return true;
+    }
+
+    // Renders every frame instead of only the ones that changed.
+    constexpr void set_continuous(const bool continuous) noexcept
+    {
+        this->m_continuous = continuous;
+    }
+
     inline void run() noexcept
     {
+        const auto replaying = this->m_player.has_value();
         auto loc = eqx::lib::Point<float>{};
+        auto loop = eqx::ogl::Loop{
+            replaying ? this->m_player->get_tick() : c_tick };
+        auto previous = this->m_sim;
+        auto input = eqx::ogl::Input_Frame{};
         auto frame_timer = eqx::ogl::Frame_Timer{};
-        auto sim_timer = eqx::lib::Timer{};
-        auto seconds = 0.0F;
-        constexpr auto tick = 1.0F / 60.0F;
+        auto ticks = 0ull;
+        auto idle_waits = 0ull;
+
+        // Frames are published at most this often, the render thread draws
+        // the newest one each vsync. A replay runs one tick per iteration
+        // and renders every tick as fast as possible instead.
+        loop.set_render_rate(240.0F);
+        if (replaying)
+        {
+            this->m_window.set_present_mode(
+                eqx::ogl::Window::Present_Mode::Immediate);
+        }
+
+        // Unless running continuously a frame is only published when it
+        // differs from the last one: a tick moved something, interpolation
+        // between the last two ticks is still in flight, the window was
+        // resized or the map is still streaming. Once the sim has settled
+        // the loop blocks on events instead of ticking.
+        const auto on_demand = !replaying && !this->m_continuous;
+        auto damaged = true;
+        auto woken = false;
+        auto size = this->m_window.get_framebuffer_size();
+
+        auto render_thread = eqx::ogl::Render_Thread<Frame>{ this->m_window,
+            [this](const Frame& frame) noexcept
+            {
+                this->m_renderer.render(frame.previous, frame.current,
+                    frame.alpha);
+            } };
+        render_thread.set_on_demand(on_demand);
 
-        sim_timer.start();
+        const auto start = std::chrono::steady_clock::now();
         while (!this->m_window.should_close())
         {
-            seconds += sim_timer.readf();
-            sim_timer.start();
-
-            this->m_window.clear();
+            const auto steps = replaying ? 1 : loop.advance();
 
             loc = this->m_window.get_cursor_location();
             this->m_window.set_name(std::format(
@@ -618,18 +1005,79 @@ public:
                 "Location: ({}, {}) --- "sv
                 "Frames: {} --- "sv
                 "FPS: {}"sv,
-                loc.get_x(), loc.get_y(), frame_timer.get_frames(),
-                frame_timer.get_fps()));
+                loc.get_x(), loc.get_y(), render_thread.get_frames(),
+                render_thread.get_fps()));
 
-            this->handle_input();
+            if (!replaying)
+            {
+                // Scroll is kept until a tick consumes it, a frame may run
+                // no ticks at all.
+                const auto scroll = input.scroll;
+                input = eqx::ogl::Input_Frame::capture(
+                    this->m_window.get_input(), this->to_world(loc));
+                input.scroll = eqx::lib::Point<float>::translate(
+                    input.scroll, scroll);
+            }
 
-            while (seconds > tick)
+            for (auto i = 0; i < steps; ++i)
             {
-                this->m_sim.update(tick);
-                seconds -= tick;
+                if (replaying)
+                {
+                    const auto next = this->m_player->next();
+                    if (!next.has_value())
+                    {
+                        if (!this->m_player->valid())
+                        {
+                            std::format_to(
+                                std::ostream_iterator<char>(std::cerr),
+                                "Corrupt recording, stopped after {} "sv
+                                "ticks\n"sv, ticks);
+                        }
+                        this->m_window.close();
+                        break;
+                    }
+                    input = next.value();
+                }
+
+                if (this->m_recorder.has_value())
+                {
+                    this->m_recorder->record(input);
+                }
+
+                {
+                    const auto zone =
+                        eqx::ogl::Zone{ "MGame::handle_input"sv };
+                    this->handle_input(input);
+                }
+                input.scroll = eqx::lib::Point<float>::origin();
+
+                const auto zone = eqx::ogl::Zone{ "Sim::update"sv };
+                damaged = damaged || !this->m_sim.settled(previous);
+                previous = this->m_sim;
+                this->m_sim.update(loop.get_tick());
+                emit_effects(previous, this->m_sim,
+                    this->m_renderer.get_particles());
+                ++ticks;
+                woken = false;
             }
 
-            this->m_renderer.render(this->m_sim);
+            const auto current_size = this->m_window.get_framebuffer_size();
+            damaged = damaged || current_size != size;
+            size = current_size;
+
+            const auto animating = !this->m_sim.settled(previous)
+                || this->m_renderer.busy();
+            if ((!on_demand || damaged || animating)
+                && (replaying || loop.should_render()))
+            {
+                const auto zone = eqx::ogl::Zone{ "MGame::publish"sv };
+                auto& frame = render_thread.get_write_buffer();
+                frame.previous = previous;
+                frame.current = this->m_sim;
+                frame.alpha = replaying ? 1.0F : loop.get_alpha();
+                render_thread.publish();
+                damaged = false;
+            }
 
             if (this->m_window.key_down(eqx::ogl::Window::Key::Escape))
             {
@@ -638,97 +1086,176 @@ public:
 
             if constexpr (c_smoke == true)
             {
-                this->m_window.close();
+                if (render_thread.get_frames() > 0ull)
+                {
+                    this->m_window.close();
+                }
             }
 
-            this->m_window.swap();
-            this->m_window.poll();
             frame_timer.update();
+            if (on_demand && !damaged && !animating && !woken)
+            {
+                // Whatever woke the loop gets at least one tick to act on.
+                this->m_window.wait(c_idle_timeout);
+                loop.resume();
+                woken = true;
+                ++idle_waits;
+            }
+            else
+            {
+                this->m_window.poll();
+                if (!replaying)
+                {
+                    loop.wait();
+                }
+            }
+        }
+
+        if (on_demand)
+        {
+            std::format_to(std::ostream_iterator<char>(std::cout),
+                "{} ticks, {} frames rendered, {} idle waits\n"sv,
+                ticks, render_thread.get_frames(), idle_waits);
+        }
+
+        if (replaying)
+        {
+            const auto seconds = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start).count();
+            const auto stats = frame_timer.get_stats();
+            std::format_to(std::ostream_iterator<char>(std::cout),
+                "Replay: {} ticks in {:.3f}s ({:.1f} ticks/s), "sv
+                "{} frames rendered\n"sv
+                "Tick p50: {:.3f}ms p95: {:.3f}ms p99: {:.3f}ms "sv
+                "max: {:.3f}ms\n"sv,
+                ticks, seconds, static_cast<double>(ticks) / seconds,
+                render_thread.get_frames(),
+                stats.p50, stats.p95, stats.p99, stats.max);
         }
     }
 
+    [[nodiscard]] inline bool has_map() const noexcept
+    {
+        return this->m_renderer.has_map();
+    }
+
+    inline void report() const noexcept
+    {
+        for (const auto& [name, stats] : eqx::ogl::Gpu_Profiler::get_all())
+        {
+            std::format_to(std::ostream_iterator<char>(std::cout),
+                "GPU {}: {} frames, avg {:.3f}ms, max {:.3f}ms\n"sv,
+                name, stats.count, stats.average_ms(), stats.max_ms);
+        }
+
+        const auto& batch = this->m_renderer.get_batch();
+        const auto& queue = this->m_renderer.get_queue().get_stats();
+        std::format_to(std::ostream_iterator<char>(std::cout),
+            "Last frame: {} of {} units visible, {} sprites in {} draws\n"sv
+            "Texture changes: {} submitted, {} sorted\n"sv
+            "Program changes: {} submitted, {} sorted\n"sv
+            "Background redraws: {}\n"sv
+            "Particles emitted: {}\n"sv,
+            this->m_renderer.get_visible(), this->m_renderer.get_units(),
+            batch.get_sprites(), batch.get_draws(),
+            queue.submitted_texture_changes, queue.texture_changes,
+            queue.submitted_program_changes, queue.program_changes,
+            this->m_renderer.get_background().get_renders(),
+            this->m_renderer.get_particles().get_emitted());
+    }
+
 private:
-    inline void handle_input() noexcept
+    [[nodiscard]] inline eqx::lib::Point<float> to_world(
+        const eqx::lib::Point<float>& click) const noexcept
     {
         const auto [width, height] = get_wh(this->m_sim.view());
         const auto dimensions = this->m_window.get_dimensions();
-        const auto click = this->m_window.get_cursor_location();
         const auto scale = eqx::lib::Point<float>{
             click.get_x() / dimensions.get_x(),
             click.get_y() / dimensions.get_y() };
         const auto offset = eqx::lib::Point<float>{
             width * scale.get_x(), height * scale.get_y() };
-        const auto world_coordinate = eqx::lib::Point<float>::translate(
+        return eqx::lib::Point<float>::translate(
             this->m_sim.view().get_data()[1], offset);
+    }
 
-        if (this->m_window.mouse_button_down(
+    inline void handle_input(const eqx::ogl::Input_Frame& input) noexcept
+    {
+        const auto& world_coordinate = input.cursor;
+
+        if (input.mouse_button_down(
             eqx::ogl::Window::Mouse_Button::Left))
         {
             this->m_sim.select_unit(world_coordinate);
         }
 
-        if (this->m_window.mouse_button_down(
+        if (input.mouse_button_down(
             eqx::ogl::Window::Mouse_Button::Right))
         {
             this->m_sim.move_unit(world_coordinate);
         }
 
-        if (this->m_window.key_down(eqx::ogl::Window::Key::B))
+        if (input.key_down(eqx::ogl::Window::Key::B))
         {
             this->m_sim.stop_unit();
         }
 
         auto view = eqx::lib::Point<float>{};
 
-        if (this->m_window.key_down(eqx::ogl::Window::Key::A)
-            && this->m_window.key_down(eqx::ogl::Window::Key::D))
+        if (input.key_down(eqx::ogl::Window::Key::A)
+            && input.key_down(eqx::ogl::Window::Key::D))
         {
             view.set_x(0.0F);
         }
-        else if (this->m_window.key_up(eqx::ogl::Window::Key::A)
-            && this->m_window.key_up(eqx::ogl::Window::Key::D))
+        else if (input.key_up(eqx::ogl::Window::Key::A)
+            && input.key_up(eqx::ogl::Window::Key::D))
         {
             view.set_x(0.0F);
         }
-        else if (this->m_window.key_down(eqx::ogl::Window::Key::A))
+        else if (input.key_down(eqx::ogl::Window::Key::A))
         {
             view.set_x(-1.0F);
         }
-        else if (this->m_window.key_down(eqx::ogl::Window::Key::D))
+        else if (input.key_down(eqx::ogl::Window::Key::D))
         {
             view.set_x(1.0F);
         }
 
-        if (this->m_window.key_down(eqx::ogl::Window::Key::W)
-            && this->m_window.key_down(eqx::ogl::Window::Key::S))
+        if (input.key_down(eqx::ogl::Window::Key::W)
+            && input.key_down(eqx::ogl::Window::Key::S))
         {
             view.set_y(0.0F);
         }
-        else if (this->m_window.key_up(eqx::ogl::Window::Key::W)
-            && this->m_window.key_up(eqx::ogl::Window::Key::S))
+        else if (input.key_up(eqx::ogl::Window::Key::W)
+            && input.key_up(eqx::ogl::Window::Key::S))
         {
             view.set_y(0.0F);
         }
-        else if (this->m_window.key_down(eqx::ogl::Window::Key::W))
+        else if (input.key_down(eqx::ogl::Window::Key::W))
         {
             view.set_y(1.0F);
         }
-        else if (this->m_window.key_down(eqx::ogl::Window::Key::S))
+        else if (input.key_down(eqx::ogl::Window::Key::S))
         {
             view.set_y(-1.0F);
         }
 
-        const auto sy = eqx::ogl::Window::get_scroll_offset().get_y();
-        eqx::ogl::Window::reset_scroll_offset();
+        const auto sy = input.scroll.get_y();
         const auto zoom = eqx::lib::Math::near(sy, 0.0F)
             ? 0.0F : std::copysign(1.0F, -sy);
 
         this->m_sim.set_view_state(view.get_x(), view.get_y(), zoom);
     }
 
+    static constexpr auto c_tick = 1.0F / 60.0F;
+    static constexpr auto c_idle_timeout = 1.0;
+
     eqx::ogl::Window m_window;
     Sim m_sim;
     Renderer m_renderer;
+    std::optional<eqx::ogl::Input_Recorder> m_recorder;
+    std::optional<eqx::ogl::Input_Player> m_player;
+    bool m_continuous;
 };
 
 /*
@@ -871,15 +1398,84 @@ int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
 {
     std::format_to(std::ostream_iterator<char>(std::cout), "Start\n\n"sv);
 
-    eqx::ogl::init();
+    // --record <file> saves every tick's input, --replay <file> plays it
+    // back headless at full speed. --continuous renders every frame even
+    // when nothing changed.
+    auto record = std::optional<std::filesystem::path>{};
+    auto replay = std::optional<std::filesystem::path>{};
+    auto continuous = false;
+    const auto args = std::span{ argv, static_cast<std::size_t>(argc) };
+    for (auto i = std::size_t{ 1 }; i < std::ranges::size(args); ++i)
+    {
+        const auto has_value = i + 1 < std::ranges::size(args);
+        if (args[i] == "--record"sv && has_value)
+        {
+            record = args[++i];
+        }
+        else if (args[i] == "--replay"sv && has_value)
+        {
+            replay = args[++i];
+        }
+        else if (args[i] == "--continuous"sv)
+        {
+            continuous = true;
+        }
+    }
+
+    if (replay.has_value())
+    {
+        eqx::ogl::init(eqx::ogl::backend_from_env()
+            == eqx::ogl::Backend::OSMesa
+            ? eqx::ogl::Backend::OSMesa : eqx::ogl::Backend::Egl);
+    }
+    else
+    {
+        eqx::ogl::init();
+    }
+
+    const auto trace = eqx::ogl::Trace::enable_from_env();
+    eqx::ogl::Trace::set_thread_name("Main"sv);
 
+    auto ok = true;
     {
         auto mgame = MGame{};
-        mgame.run();
+        mgame.set_continuous(continuous);
+        if (record.has_value())
+        {
+            mgame.record(record.value());
+        }
+        if (!mgame.has_map())
+        {
+            std::format_to(std::ostream_iterator<char>(std::cerr),
+                "./Resources/MGame.pack does not hold the map\n"sv);
+            ok = false;
+        }
+        else if (replay.has_value() && !mgame.replay(replay.value()))
+        {
+            std::format_to(std::ostream_iterator<char>(std::cerr),
+                "{} is not a valid recording\n"sv, replay->string());
+            ok = false;
+        }
+        else
+        {
+            mgame.run();
+            mgame.report();
+        }
     }
 
     eqx::ogl::free();
 
+    if (trace.has_value() && !eqx::ogl::Trace::write(trace.value()))
+    {
+        std::format_to(std::ostream_iterator<char>(std::cerr),
+            "Could not write trace to {}\n"sv, trace->string());
+    }
+
+    if (!ok)
+    {
+        return EXIT_FAILURE;
+    }
+
     std::format_to(std::ostream_iterator<char>(std::cout), "\nEnd\n"sv);
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,173 @@
+// Main.cpp
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glm/glm.hpp>;
+import Eqx.Lib;
+import Eqx.OGL.Window;
+import Eqx.OGL.Pack;
+import Eqx.OGL.Shader_Program;
+import Eqx.OGL.Vertex_Array;
+import Eqx.OGL.Texture;
+
+using namespace std::literals;
+
+#ifdef EQX_SMOKE
+    constexpr auto c_smoke = true;
+#else
+    constexpr auto c_smoke = false;
+#endif // EQX_SMOKE
+
+/*
+ * Copies of the pack with a truncated table of contents, an entry reaching
+ * past the end and a texture whose size disagrees with its dimensions must
+ * all be rejected.
+ */
+[[nodiscard]] bool rejects_corruption(
+    const std::filesystem::path& path) noexcept
+{
+    auto file = std::ifstream{ path, std::ios::binary };
+    const auto bytes = std::vector<char>{
+        std::istreambuf_iterator<char>{ file },
+        std::istreambuf_iterator<char>{} };
+
+    auto header = eqx::ogl::Pack_Header{};
+    std::memcpy(&header, std::ranges::data(bytes), sizeof(header));
+    const auto toc = static_cast<std::size_t>(header.toc_offset);
+
+    const auto rejected = [&path](const std::vector<char>& corrupt) noexcept
+    {
+        const auto copy = std::filesystem::path{ path }
+            .replace_filename("Corrupt.pack"sv);
+        {
+            auto out = std::ofstream{ copy, std::ios::binary };
+            out.write(std::ranges::data(corrupt),
+                static_cast<std::streamsize>(std::ranges::size(corrupt)));
+        }
+
+        const auto pack = eqx::ogl::Pack{ copy };
+        return !pack.valid();
+    };
+
+    auto truncated = bytes;
+    truncated.resize(toc + sizeof(eqx::ogl::Pack_Entry) / 2);
+
+    auto overrun = bytes;
+    auto entry = eqx::ogl::Pack_Entry{};
+    std::memcpy(&entry, std::ranges::data(bytes) + toc, sizeof(entry));
+    entry.size = std::ranges::size(bytes);
+    std::memcpy(std::ranges::data(overrun) + toc, &entry, sizeof(entry));
+
+    auto resized = bytes;
+    for (auto i = std::size_t{ 0 }; i < header.entry_count; ++i)
+    {
+        const auto at = toc + i * sizeof(eqx::ogl::Pack_Entry);
+        std::memcpy(&entry, std::ranges::data(bytes) + at, sizeof(entry));
+        if (entry.kind == eqx::ogl::Pack_Kind::Texture)
+        {
+            ++entry.width;
+            std::memcpy(std::ranges::data(resized) + at, &entry,
+                sizeof(entry));
+            break;
+        }
+    }
+
+    return rejected(truncated) && rejected(overrun) && rejected(resized)
+        && resized != bytes;
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
+{
+    std::format_to(std::ostream_iterator<char>(std::cout), "Start\n\n"sv);
+
+    constexpr auto path = "./Resources/Assets.pack"sv;
+    auto pack = eqx::ogl::Pack{ path };
+    const auto vertex_source =
+        pack.get_shader("Shaders/Texture/Vertex.glsl"sv);
+    const auto fragment_source =
+        pack.get_shader("Shaders/Texture/Fragment.glsl"sv);
+    const auto texels = pack.get_texture("Textures/Box.png"sv);
+    if (!pack.valid() || !vertex_source.has_value()
+        || !fragment_source.has_value() || !texels.has_value()
+        || pack.get_texture("Shaders/Texture/Vertex.glsl"sv).has_value()
+        || !rejects_corruption(path))
+    {
+        std::format_to(std::ostream_iterator<char>(std::cerr),
+            "{} was not read as expected\n"sv, path);
+        return EXIT_FAILURE;
+    }
+
+    eqx::ogl::init();
+
+    auto loc = eqx::lib::Point<float>{};
+
+    auto window = eqx::ogl::Window{ 1920, 1080, "eqx::OGL --- Test Pack"sv };
+    auto shader_program = eqx::ogl::Shader_Program::from_source(
+        vertex_source.value(), fragment_source.value());
+    auto vertex_array = eqx::ogl::Vertex_Array{
+        std::array<float, 16>{
+            0.5f, 0.5f, 1.0f, 0.0f,
+            -0.5f, 0.5f, 0.0f, 0.0f,
+            0.5f, -0.5f, 1.0f, 1.0f,
+            -0.5f, -0.5f, 0.0f, 1.0f },
+        std::array<unsigned int, 2>{ 2u, 2u },
+        std::array<unsigned int, 6>{
+            0u, 1u, 2u,
+            1u, 3u, 2u } };
+    auto texture = eqx::ogl::Texture{ texels.value() };
+
+    auto model = glm::translate(glm::mat4{ 1.0f },
+        glm::vec3{ 0.0f, 0.0f, 0.0f });
+    model = glm::scale(model, glm::vec3{ 100.0f, 100.0f, 1.0f });
+    auto view = glm::mat4{ 1.0f };
+    auto proj = glm::ortho(0.0f, 1920.0f, -1080.0f, 0.0f);
+    shader_program.set_mat4("u_model"sv, model);
+    shader_program.set_mat4("u_view"sv, view);
+    shader_program.set_mat4("u_proj"sv, proj);
+
+    shader_program.activate_texture("u_tex0"sv, 0);
+
+    auto frame_timer = eqx::ogl::Frame_Timer{};
+    while (!window.should_close())
+    {
+        window.clear();
+
+        loc = window.get_cursor_location();
+        window.set_name(std::format(
+            "eqx::ogl --- "sv
+            "Test Pack --- "sv
+            "Location: ({}, {}) --- "sv
+            "Frames: {} --- "sv
+            "FPS: {}"sv,
+            loc.get_x(), loc.get_y(), frame_timer.get_frames(),
+            frame_timer.get_fps()));
+
+        model = glm::translate(glm::mat4{ 1.0f },
+            glm::vec3{ loc.get_x(), loc.get_y(), 0.0f });
+        model = glm::scale(model, glm::vec3{ 100.0f, 100.0f, 1.0f });
+        shader_program.set_mat4("u_model"sv, model);
+
+        shader_program.enable();
+        vertex_array.enable();
+        texture.enable(0);
+        eqx::ogl::draw(vertex_array.get_index_count());
+
+        if constexpr (c_smoke == true)
+        {
+            window.close();
+        }
+
+        frame_timer.update();
+        window.swap();
+        window.poll();
+    }
+
+    shader_program.free();
+    vertex_array.free();
+    texture.free();
+    pack.free();
+    window.free();
+    eqx::ogl::free();
+
+    std::format_to(std::ostream_iterator<char>(std::cout), "\nEnd\n"sv);
+    return EXIT_SUCCESS;
+}
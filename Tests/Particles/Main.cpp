@@ -0,0 +1,120 @@
+// Main.cpp
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glad/glad.hpp>;
+import <Eqx/TPL/glm/glm.hpp>;
+import Eqx.Lib;
+import Eqx.OGL.Particle_System;
+import Eqx.OGL.Window;
+
+using namespace std::literals;
+
+#ifdef EQX_SMOKE
+    constexpr auto c_smoke = true;
+#else
+    constexpr auto c_smoke = false;
+#endif // EQX_SMOKE
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
+{
+    std::format_to(std::ostream_iterator<char>(std::cout), "Start\n\n"sv);
+
+    constexpr auto frames = c_smoke ? 10 : 100'000;
+    constexpr auto sparks = 500u;
+    constexpr auto tick = 1.0F / 60.0F;
+    constexpr auto pi = std::numbers::pi_v<float>;
+
+    eqx::ogl::init();
+
+    auto ok = true;
+    {
+        auto window = eqx::ogl::Window{ 640, 480,
+            "eqx::ogl --- Test Particles"sv };
+
+        // Tens of thousands alive at once, none of them touched by the CPU
+        // after emit().
+        auto particles = eqx::ogl::Particle_System{ 50'000ull };
+        particles.get_draw_program().set_mat4("u_view"sv, glm::mat4{ 1.0F });
+        particles.get_draw_program().set_mat4("u_proj"sv,
+            glm::ortho(0.0F, 640.0F, 480.0F, 0.0F));
+        particles.set_style(0u, eqx::ogl::Particle_Style{
+            glm::vec4(1.0F, 0.6F, 0.2F, 0.0F),
+            glm::vec4(0.3F, 0.05F, 0.0F, 0.0F),
+            1.5F, 1.0F, 0.01F, 0.5F, eqx::lib::Point<float>{ 0.0F, 300.0F } });
+        particles.set_style(1u, eqx::ogl::Particle_Style{
+            glm::vec4(0.25F, 0.25F, 0.25F, 0.5F),
+            glm::vec4(0.0F, 0.0F, 0.0F, 0.0F),
+            6.0F, 30.0F, 0.0F, 1.0F, eqx::lib::Point<float>{ 0.0F, -20.0F } });
+
+        eqx::ogl::blend_premultiplied(true);
+        auto last = std::chrono::steady_clock::now();
+        for (auto i = 0; i < frames && !window.should_close(); ++i)
+        {
+            // A fountain of sparks, smoke follows the cursor while the left
+            // button is held.
+            particles.emit(eqx::ogl::Particle_Emission{
+                eqx::lib::Point<float>{ 320.0F, 420.0F }, -pi / 2.0F, 0.4F,
+                200.0F, 400.0F, 1.0F, 2.0F, 4.0F, 0u, sparks });
+            if (window.mouse_button_down(
+                eqx::ogl::Window::Mouse_Button::Left))
+            {
+                particles.emit(eqx::ogl::Particle_Emission{
+                    window.get_cursor_location(), 0.0F, pi, 10.0F, 40.0F,
+                    1.0F, 3.0F, 10.0F, 1u, 50u });
+            }
+
+            const auto now = std::chrono::steady_clock::now();
+            const auto dt = c_smoke ? tick : std::min(
+                std::chrono::duration<float>(now - last).count(), 0.1F);
+            last = now;
+
+            glClear(GL_COLOR_BUFFER_BIT);
+            particles.update(dt);
+            particles.draw();
+
+            if (i == frames - 1)
+            {
+                const auto pixels = window.read_pixels();
+                const auto lit = std::ranges::count_if(
+                    std::views::iota(0ull, std::ranges::size(pixels) / 4ull),
+                    [&pixels](const std::size_t p) noexcept
+                    {
+                        return pixels[p * 4ull] != pixels[0];
+                    });
+
+                std::format_to(std::ostream_iterator<char>(std::cout),
+                    "Particles: {} emitted in {} updates, capacity {} "sv
+                    "of {} bytes each\n"sv
+                    "Lit pixels: {}\n"sv,
+                    particles.get_emitted(), particles.get_updates(),
+                    particles.get_capacity(),
+                    eqx::ogl::Particle_System::get_record_bytes(), lit);
+
+                ok = particles.get_emitted()
+                    >= static_cast<unsigned long long>(frames) * sparks
+                    && lit > 0;
+            }
+
+            if (window.key_down(eqx::ogl::Window::Key::Escape))
+            {
+                window.close();
+            }
+
+            window.swap();
+            window.poll();
+        }
+        eqx::ogl::blend_premultiplied(false);
+    }
+
+    eqx::ogl::free();
+
+    if (!ok)
+    {
+        std::format_to(std::ostream_iterator<char>(std::cerr),
+            "Particles were not emitted or drawn as expected\n"sv);
+        return EXIT_FAILURE;
+    }
+
+    std::format_to(std::ostream_iterator<char>(std::cout), "\nEnd\n"sv);
+    return EXIT_SUCCESS;
+}
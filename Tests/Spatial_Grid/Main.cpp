@@ -0,0 +1,179 @@
+// Main.cpp
+
+import <Eqx/std.hpp>;
+import Eqx.OGL.Spatial_Grid;
+
+using namespace std::literals;
+
+#ifdef EQX_SMOKE
+    constexpr auto c_smoke = true;
+#else
+    constexpr auto c_smoke = false;
+#endif // EQX_SMOKE
+
+using Handle = eqx::ogl::Spatial_Grid::Handle;
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
+{
+    std::format_to(std::ostream_iterator<char>(std::cout), "Start\n\n"sv);
+
+    constexpr auto steps = c_smoke ? 2'000 : 200'000;
+    constexpr auto cell = 64.0F;
+    constexpr auto world = 1'024.0F;
+
+    auto rng = std::mt19937{ 42u };
+    auto coordinate = std::uniform_real_distribution<float>{ -world, world };
+    auto extent = std::uniform_real_distribution<float>{ 0.0F, 3.0F * cell };
+    auto action = std::uniform_int_distribution<int>{ 0, 9 };
+
+    // Every fourth box is snapped to cell edges, so bounds landing exactly
+    // on a boundary, including negative ones, get covered as well.
+    const auto random_box = [&]() noexcept
+    {
+        auto x = coordinate(rng);
+        auto y = coordinate(rng);
+        auto w = extent(rng);
+        auto h = extent(rng);
+        if (rng() % 4u == 0u)
+        {
+            x = std::floor(x / cell) * cell;
+            y = std::floor(y / cell) * cell;
+            w = std::floor(w / cell) * cell;
+            h = std::floor(h / cell) * cell;
+        }
+
+        return eqx::ogl::Aabb{ x, y, x + w, y + h };
+    };
+
+    auto grid = eqx::ogl::Spatial_Grid{ cell };
+    auto mirror = std::vector<std::optional<eqx::ogl::Aabb>>{};
+    auto live = std::vector<Handle>{};
+
+    const auto brute_force = [&mirror](const eqx::ogl::Aabb& area) noexcept
+    {
+        auto result = std::vector<Handle>{};
+        for (auto handle = Handle{ 0 }; handle < std::ranges::size(mirror);
+            ++handle)
+        {
+            if (mirror[handle].has_value() && mirror[handle]->overlaps(area))
+            {
+                result.push_back(handle);
+            }
+        }
+
+        return result;
+    };
+
+    auto ok = true;
+    auto queries = 0ull;
+    auto found = 0ull;
+    auto result = std::vector<Handle>{};
+    const auto check = [&](const eqx::ogl::Aabb& area) noexcept
+    {
+        result.clear();
+        grid.query(area, result);
+        std::ranges::sort(result);
+        ok = ok && result == brute_force(area);
+        ++queries;
+        found += std::ranges::size(result);
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < steps; ++i)
+    {
+        const auto roll = action(rng);
+        if (roll < 4 || std::ranges::empty(live))
+        {
+            const auto bounds = random_box();
+            const auto handle = grid.insert(bounds);
+            ok = ok && grid.contains(handle)
+                && (handle >= std::ranges::size(mirror)
+                    || !mirror[handle].has_value());
+            if (handle >= std::ranges::size(mirror))
+            {
+                mirror.resize(handle + 1u);
+            }
+            mirror[handle] = bounds;
+            live.push_back(handle);
+        }
+        else if (roll < 7)
+        {
+            // Mostly small moves that stay within the same cells, the rest
+            // jump anywhere.
+            const auto handle = live[rng() % std::ranges::size(live)];
+            auto bounds = *mirror[handle];
+            if (roll < 6)
+            {
+                const auto dx = coordinate(rng) / world;
+                const auto dy = coordinate(rng) / world;
+                bounds = eqx::ogl::Aabb{ bounds.left + dx, bounds.bottom + dy,
+                    bounds.right + dx, bounds.top + dy };
+            }
+            else
+            {
+                bounds = random_box();
+            }
+            grid.update(handle, bounds);
+            mirror[handle] = bounds;
+        }
+        else
+        {
+            const auto index = rng() % std::ranges::size(live);
+            const auto handle = live[index];
+            grid.remove(handle);
+            ok = ok && !grid.contains(handle);
+            mirror[handle].reset();
+            live[index] = live.back();
+            live.pop_back();
+        }
+        ok = ok && grid.get_size() == std::ranges::size(live);
+
+        check(random_box());
+        if (!std::ranges::empty(live))
+        {
+            // Querying an object's own bounds must find at least itself, and
+            // a degenerate box on its corner touches it only at the edge.
+            const auto& bounds = *mirror[live[rng() % std::ranges::size(live)]];
+            check(bounds);
+            check(eqx::ogl::Aabb{ bounds.right, bounds.top,
+                bounds.right, bounds.top });
+        }
+    }
+
+    // Cell aligned areas, the whole world, and areas outside anything
+    // inserted, including beyond the negative edge.
+    check(eqx::ogl::Aabb{ 0.0F, 0.0F, cell, cell });
+    check(eqx::ogl::Aabb{ -cell, -cell, 0.0F, 0.0F });
+    check(eqx::ogl::Aabb{ -world - cell, -world - cell,
+        world + 4.0F * cell, world + 4.0F * cell });
+    check(eqx::ogl::Aabb{ 8.0F * world, 8.0F * world,
+        9.0F * world, 9.0F * world });
+    check(eqx::ogl::Aabb{ -9.0F * world, -9.0F * world,
+        -8.0F * world, -8.0F * world });
+
+    // Emptying the grid must leave no cells behind.
+    for (const auto handle : live)
+    {
+        grid.remove(handle);
+        mirror[handle].reset();
+    }
+    check(eqx::ogl::Aabb{ -world, -world, world, world });
+    ok = ok && grid.get_size() == 0 && grid.get_cell_count() == 0;
+    const auto end = std::chrono::steady_clock::now();
+
+    std::format_to(std::ostream_iterator<char>(std::cout),
+        "{} steps, {} queries found {} objects visiting {} entries "sv
+        "in {:.3f}ms\n"sv,
+        steps, queries, found, grid.get_visited(),
+        std::chrono::duration<double, std::milli>(end - start).count());
+
+    if (!ok)
+    {
+        std::format_to(std::ostream_iterator<char>(std::cerr),
+            "Spatial_Grid disagrees with a brute force scan\n"sv);
+        return EXIT_FAILURE;
+    }
+
+    std::format_to(std::ostream_iterator<char>(std::cout), "\nEnd\n"sv);
+    return EXIT_SUCCESS;
+}
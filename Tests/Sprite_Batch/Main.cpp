@@ -0,0 +1,289 @@
+// Main.cpp
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glad/glad.hpp>;
+import <Eqx/TPL/glm/glm.hpp>;
+import Eqx.Lib;
+import Eqx.OGL;
+
+using namespace std::literals;
+
+#ifdef EQX_SMOKE
+    constexpr auto c_smoke = true;
+#else
+    constexpr auto c_smoke = false;
+#endif // EQX_SMOKE
+
+/*
+ * Compares what the builder's workers wrote for sprites against the
+ * vertices Sprite_Batch makes of the same sprites, with the corners rotated
+ * as the Sprite vertex shader does.
+ */
+[[nodiscard]] bool matches_batch(const eqx::ogl::Sprite_Builder& builder,
+    const std::span<const eqx::ogl::Sprite> sprites,
+    const eqx::ogl::Texture& texture, const eqx::ogl::Sampler& sampler)
+    noexcept
+{
+    auto reference = eqx::ogl::Sprite_Batch{ std::ranges::size(sprites) };
+    for (const auto& sprite : sprites)
+    {
+        const auto c = std::cos(sprite.rotation);
+        const auto s = std::sin(sprite.rotation);
+        const auto corner = [&sprite, c, s](const float lx,
+            const float ly) noexcept
+        {
+            return eqx::lib::Point<float>{
+                sprite.position.get_x() + lx * c - ly * s,
+                sprite.position.get_y() + lx * s + ly * c };
+        };
+
+        const auto hx = sprite.half_extents.get_x();
+        const auto hy = sprite.half_extents.get_y();
+        reference.submit(eqx::lib::Polygon<float, 4>{ corner(hx, hy),
+            corner(-hx, hy), corner(-hx, -hy), corner(hx, -hy) },
+            texture, sampler, sprite.uv);
+    }
+
+    const auto expected = reference.get_vertices();
+    auto built = std::vector<float>(std::ranges::size(expected));
+    glBindBuffer(GL_ARRAY_BUFFER, builder.get_vertex_buffer());
+    glGetBufferSubData(GL_ARRAY_BUFFER, 0, static_cast<GLsizeiptr>(
+        std::ranges::size(built) * sizeof(float)), std::ranges::data(built));
+
+    return std::ranges::equal(built, expected,
+        [](const float a, const float b) noexcept
+        {
+            return std::abs(a - b) <= 1e-3F;
+        });
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
+{
+    std::format_to(std::ostream_iterator<char>(std::cout), "Start\n\n"sv);
+
+    eqx::ogl::init();
+
+    auto ok = true;
+    {
+        constexpr auto count = c_smoke ? 1'000 : 20'000;
+
+        auto loc = eqx::lib::Point<float>{};
+        auto window = eqx::ogl::Window{ 1920, 1080,
+            "eqx::ogl --- Test Sprite_Batch"sv };
+        auto shader_program = eqx::ogl::Shader_Program::from_files(
+            "./Resources/Shaders/MGame/Vertex.glsl"sv,
+            "./Resources/Shaders/MGame/Fragment.glsl"sv);
+        auto textures = std::array<eqx::ogl::Texture, 4>{
+            eqx::ogl::Texture{ "./Resources/Textures/Panzer3_Hull.png"sv },
+            eqx::ogl::Texture{ "./Resources/Textures/Panzer3_Turret.png"sv },
+            eqx::ogl::Texture{ "./Resources/Textures/M4_Sherman_Hull.png"sv },
+            eqx::ogl::Texture{ "./Resources/Textures/M4_Sherman_Turret.png"sv }
+        };
+        auto sprite_program = eqx::ogl::Shader_Program::from_files(
+            "./Resources/Shaders/Sprite/Vertex.glsl"sv,
+            "./Resources/Shaders/Sprite/Fragment.glsl"sv);
+        auto samplers = eqx::ogl::Sampler_Cache{};
+        // Room for every sprite in one flush, so each texture is one draw.
+        auto batch = eqx::ogl::Sprite_Batch{ static_cast<std::size_t>(count) };
+        auto queue = eqx::ogl::Render_Queue{};
+        auto instancer =
+            eqx::ogl::Sprite_Instancer{ static_cast<std::size_t>(count) };
+        auto builder = eqx::ogl::Sprite_Builder{};
+        auto built = std::vector<eqx::ogl::Sprite>{};
+        constexpr auto modes = std::array<std::string_view, 3>{
+            "Batched"sv, "Instanced"sv, "Built"sv };
+        auto mode = std::size_t{ 0 };
+
+        // Sprites and draws of the last frame each mode ran.
+        auto results = std::array<std::pair<unsigned long long,
+            unsigned long long>, 3>{};
+        auto verified = false;
+
+        for (auto* program : { &shader_program, &sprite_program })
+        {
+            program->set_mat4("u_view"sv, glm::mat4{ 1.0f });
+            program->set_mat4("u_proj"sv,
+                glm::ortho(0.0f, 1920.0f, -1080.0f, 0.0f));
+            program->activate_texture("u_tex0"sv, 0);
+        }
+
+        // Batched sprites are submitted with their textures interleaved and
+        // regrouped by the render queue, instanced and built ones are
+        // submitted grouped. Either way the batch only breaks three times
+        // per frame.
+        auto rng = std::mt19937{ 42u };
+        auto x = std::uniform_real_distribution<float>{ 0.0F, 1880.0F };
+        auto y = std::uniform_real_distribution<float>{ -1040.0F, 0.0F };
+        auto sprites = std::vector<eqx::lib::Point<float>>{};
+        sprites.reserve(count);
+        for (auto i = 0; i < count; ++i)
+        {
+            sprites.push_back(eqx::lib::Point<float>{ x(rng), y(rng) });
+        }
+
+        auto frame_timer = eqx::ogl::Frame_Timer{};
+        while (!window.should_close())
+        {
+            window.clear();
+
+            loc = window.get_cursor_location();
+            window.set_name(std::format(
+                "eqx::ogl --- "sv
+                "Test Sprite_Batch --- "sv
+                "{} --- "sv
+                "Sprites: {} --- "sv
+                "Draws: {} --- "sv
+                "Frames: {} --- "sv
+                "FPS: {}"sv,
+                modes[mode],
+                batch.get_sprites() + instancer.get_sprites()
+                    + builder.get_sprites(),
+                batch.get_draws() + instancer.get_draws()
+                    + builder.get_draws(),
+                frame_timer.get_frames(), frame_timer.get_fps()));
+
+            // Space cycles between four corners per sprite expanded on this
+            // thread, one compact instance record per sprite expanded on
+            // the GPU and four corners expanded by the builder's workers.
+            batch.reset_stats();
+            instancer.reset_stats();
+            builder.reset_stats();
+            const auto& sampler =
+                samplers.get(eqx::ogl::Sampler_State::linear());
+            const auto offset =
+                eqx::lib::Point<float>{ loc.get_x() * 0.01F, 0.0F };
+            if (mode == 1)
+            {
+                sprite_program.enable();
+                for (auto i = std::size_t{ 0 };
+                    i < std::ranges::size(sprites); ++i)
+                {
+                    instancer.submit(eqx::ogl::Sprite{
+                        eqx::lib::Point<float>::translate(sprites[i], offset),
+                        eqx::lib::Point<float>{ 20.0F, 20.0F },
+                        static_cast<float>(i) * 0.01F },
+                        textures[i * std::ranges::size(textures)
+                            / std::ranges::size(sprites)], sampler);
+                }
+                instancer.flush();
+            }
+            else if (mode == 2)
+            {
+                built.clear();
+                for (auto i = std::size_t{ 0 };
+                    i < std::ranges::size(sprites); ++i)
+                {
+                    built.push_back(eqx::ogl::Sprite{
+                        eqx::lib::Point<float>::translate(sprites[i], offset),
+                        eqx::lib::Point<float>{ 20.0F, 20.0F },
+                        static_cast<float>(i) * 0.01F });
+                }
+
+                shader_program.enable();
+                const auto quarter = std::ranges::size(built)
+                    / std::ranges::size(textures);
+                for (auto i = std::size_t{ 0 };
+                    i < std::ranges::size(textures); ++i)
+                {
+                    const auto last = i + 1 == std::ranges::size(textures);
+                    builder.submit(std::span<const eqx::ogl::Sprite>{ built }
+                        .subspan(i * quarter,
+                            last ? std::dynamic_extent : quarter),
+                        textures[i], sampler);
+                }
+                builder.flush();
+
+                if (!verified)
+                {
+                    ok = ok && matches_batch(builder, built, textures[0],
+                        sampler);
+                    verified = true;
+                }
+            }
+            else
+            {
+                for (auto i = std::size_t{ 0 };
+                    i < std::ranges::size(sprites); ++i)
+                {
+                    auto quad =
+                        eqx::lib::Polygon<float, 4>::rectangle(40.0F, 40.0F);
+                    quad.translate(
+                        eqx::lib::Point<float>::translate(sprites[i], offset));
+                    queue.submit(0u, false, 0.0F, shader_program,
+                        textures[i % std::ranges::size(textures)], sampler,
+                        quad);
+                }
+                // Submitted round robin, so sorting must group every
+                // texture into one run.
+                queue.sort();
+                ok = ok && std::ranges::is_sorted(queue.get_keys());
+                queue.execute(batch);
+
+                ok = ok && queue.get_stats().texture_changes
+                    < queue.get_stats().submitted_texture_changes;
+            }
+
+            // Every mode draws each sprite once and each texture in one
+            // draw.
+            results[mode] = std::make_pair(
+                batch.get_sprites() + instancer.get_sprites()
+                    + builder.get_sprites(),
+                batch.get_draws() + instancer.get_draws()
+                    + builder.get_draws());
+            ok = ok && results[mode].first
+                    == static_cast<unsigned long long>(count)
+                && results[mode].second == std::ranges::size(textures);
+
+            if (window.key_pressed(eqx::ogl::Window::Key::Space))
+            {
+                mode = (mode + 1) % std::ranges::size(modes);
+            }
+
+            if (window.key_down(eqx::ogl::Window::Key::Escape))
+            {
+                window.close();
+            }
+
+            if constexpr (c_smoke == true)
+            {
+                if (mode + 1 == std::ranges::size(modes))
+                {
+                    window.close();
+                }
+                mode = (mode + 1) % std::ranges::size(modes);
+            }
+
+            frame_timer.update();
+            window.swap();
+            window.poll();
+        }
+
+        const auto stats = frame_timer.get_stats();
+        std::format_to(std::ostream_iterator<char>(std::cout),
+            "Batched: {} bytes per sprite, {} sprites in {} draws, "sv
+            "{} texture changes sorted from {}\n"sv
+            "Instanced: {} bytes per sprite, {} sprites in {} draws\n"sv
+            "Built: {} sprites in {} draws on {} of {} threads\n"sv
+            "p50: {:.3f}ms p99: {:.3f}ms max: {:.3f}ms\n"sv,
+            16ull * sizeof(float), results[0].first, results[0].second,
+            queue.get_stats().texture_changes,
+            queue.get_stats().submitted_texture_changes,
+            eqx::ogl::Sprite_Instancer::get_record_bytes(),
+            results[1].first, results[1].second,
+            results[2].first, results[2].second, builder.get_parts(),
+            builder.get_workers() + 1,
+            stats.p50, stats.p99, stats.max);
+    }
+
+    eqx::ogl::free();
+
+    if (!ok)
+    {
+        std::format_to(std::ostream_iterator<char>(std::cerr),
+            "Sprite counts, draw counts or vertices are not as expected\n"sv);
+        return EXIT_FAILURE;
+    }
+
+    std::format_to(std::ostream_iterator<char>(std::cout), "\nEnd\n"sv);
+    return EXIT_SUCCESS;
+}
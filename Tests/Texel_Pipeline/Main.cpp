@@ -0,0 +1,149 @@
+// Main.cpp
+
+import <Eqx/std.hpp>;
+import Eqx.OGL.Texel_Pipeline;
+
+using namespace std::literals;
+
+#ifdef EQX_SMOKE
+    constexpr auto c_smoke = true;
+#else
+    constexpr auto c_smoke = false;
+#endif // EQX_SMOKE
+
+using Isa = eqx::ogl::Texel_Pipeline::Isa;
+
+template <typename T_Func>
+[[nodiscard]] double time_ms(const int iterations, T_Func&& func) noexcept
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (auto i = 0; i < iterations; ++i)
+    {
+        func();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count()
+        / iterations;
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
+{
+    std::format_to(std::ostream_iterator<char>(std::cout), "Start\n\n"sv);
+
+    constexpr auto width = c_smoke ? 257 : 4'096;
+    constexpr auto height = c_smoke ? 129 : 4'096;
+    constexpr auto iterations = c_smoke ? 1 : 20;
+    constexpr auto count = static_cast<std::size_t>(width * height);
+
+    auto rng = std::mt19937{ 42u };
+    auto rgb = std::vector<unsigned char>(count * 3);
+    std::ranges::generate(rgb, [&rng]() noexcept
+        {
+            return static_cast<unsigned char>(rng());
+        });
+
+    auto reference = std::vector<unsigned char>(count * 4);
+    eqx::ogl::Texel_Pipeline::expand_rgb(rgb, reference, Isa::Scalar);
+
+    // Expanded texels are all opaque, which premultiply leaves unchanged,
+    // so it gets its own input with every alpha including 0 and 255.
+    auto source = std::vector<unsigned char>(count * 4);
+    std::ranges::generate(source, [&rng]() noexcept
+        {
+            return static_cast<unsigned char>(rng());
+        });
+    for (auto i = std::size_t{ 0 }; i < count; ++i)
+    {
+        if (i % 7 == 0)
+        {
+            source[i * 4 + 3] = 0u;
+        }
+        else if (i % 7 == 1)
+        {
+            source[i * 4 + 3] = 255u;
+        }
+    }
+
+    // Exact rounding of c * a / 255, independent of the pipeline's div255.
+    auto premultiplied = source;
+    for (auto i = std::size_t{ 0 }; i < count; ++i)
+    {
+        const auto a = static_cast<unsigned int>(source[i * 4 + 3]);
+        for (auto c = std::size_t{ 0 }; c < 3; ++c)
+        {
+            premultiplied[i * 4 + c] = static_cast<unsigned char>(
+                (2u * source[i * 4 + c] * a + 255u) / 510u);
+        }
+    }
+
+    auto isas = std::vector<Isa>{ Isa::Scalar };
+    if (eqx::ogl::Texel_Pipeline::get_isa() != Isa::Scalar)
+    {
+        isas.push_back(Isa::Ssse3);
+    }
+    if (eqx::ogl::Texel_Pipeline::get_isa() == Isa::Avx2)
+    {
+        isas.push_back(Isa::Avx2);
+    }
+
+    auto ok = true;
+    auto rgba = std::vector<unsigned char>(count * 4);
+    for (const auto isa : isas)
+    {
+        const auto expand = time_ms(iterations, [&]() noexcept
+            {
+                eqx::ogl::Texel_Pipeline::expand_rgb(rgb, rgba, isa);
+            });
+        ok = ok && rgba == reference;
+
+        auto premultiply = 0.0;
+        for (auto i = 0; i < iterations; ++i)
+        {
+            rgba = source;
+            premultiply += time_ms(1, [&]() noexcept
+                {
+                    eqx::ogl::Texel_Pipeline::premultiply(rgba, isa);
+                });
+        }
+        premultiply /= iterations;
+        ok = ok && rgba == premultiplied;
+
+        std::format_to(std::ostream_iterator<char>(std::cout),
+            "{:>6} {}x{} expand_rgb: {:.3f}ms premultiply: {:.3f}ms\n"sv,
+            eqx::ogl::Texel_Pipeline::to_string(isa), width, height,
+            expand, premultiply);
+    }
+
+    // An odd number of flips leaves the rows reversed.
+    const auto flipped_iterations = iterations | 1;
+    rgba = reference;
+    const auto flip = time_ms(flipped_iterations, [&]() noexcept
+        {
+            eqx::ogl::Texel_Pipeline::flip(rgba, width, height, 4);
+        });
+    const auto stride = static_cast<std::size_t>(width * 4);
+    for (auto y = std::size_t{ 0 }; y < static_cast<std::size_t>(height); ++y)
+    {
+        const auto row = std::ranges::begin(rgba)
+            + static_cast<std::ptrdiff_t>(y * stride);
+        const auto expected = std::ranges::begin(reference)
+            + static_cast<std::ptrdiff_t>(
+                (static_cast<std::size_t>(height) - 1 - y) * stride);
+        ok = ok && std::ranges::equal(row,
+            row + static_cast<std::ptrdiff_t>(stride), expected,
+            expected + static_cast<std::ptrdiff_t>(stride));
+    }
+    std::format_to(std::ostream_iterator<char>(std::cout),
+        "{:>6} {}x{} flip: {:.3f}ms\n"sv, "Any"sv, width, height, flip);
+
+    if (!ok)
+    {
+        std::format_to(std::ostream_iterator<char>(std::cerr),
+            "Texel kernels disagree with the reference\n"sv);
+        return EXIT_FAILURE;
+    }
+
+    std::format_to(std::ostream_iterator<char>(std::cout), "\nEnd\n"sv);
+    return EXIT_SUCCESS;
+}
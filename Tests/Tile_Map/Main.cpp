@@ -0,0 +1,195 @@
+// Main.cpp
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glm/glm.hpp>;
+import Eqx.Lib;
+import Eqx.OGL;
+
+using namespace std::literals;
+
+#ifdef EQX_SMOKE
+    constexpr auto c_smoke = true;
+#else
+    constexpr auto c_smoke = false;
+#endif // EQX_SMOKE
+
+// Four flat 16x16 tiles side by side: grass, dirt, water and stone.
+[[nodiscard]] std::vector<unsigned char> make_atlas() noexcept
+{
+    constexpr auto colors = std::array<std::array<unsigned char, 4>, 4>{
+        std::array<unsigned char, 4>{ 60u, 140u, 50u, 255u },
+        std::array<unsigned char, 4>{ 120u, 90u, 50u, 255u },
+        std::array<unsigned char, 4>{ 40u, 80u, 170u, 255u },
+        std::array<unsigned char, 4>{ 120u, 120u, 120u, 255u } };
+
+    auto texels = std::vector<unsigned char>{};
+    texels.reserve(64ull * 16ull * 4ull);
+    for (auto y = 0; y < 16; ++y)
+    {
+        for (auto x = 0; x < 64; ++x)
+        {
+            const auto& color = colors[static_cast<std::size_t>(x / 16)];
+            const auto edge = x % 16 == 0 || y == 0;
+            for (const auto channel : color)
+            {
+                texels.push_back(edge
+                    ? static_cast<unsigned char>(channel / 2) : channel);
+            }
+        }
+    }
+
+    return texels;
+}
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
+{
+    std::format_to(std::ostream_iterator<char>(std::cout), "Start\n\n"sv);
+
+    eqx::ogl::init();
+
+    auto ok = true;
+    {
+        constexpr auto size = c_smoke ? 256 : 2'048;
+        constexpr auto tile_size = 32.0F;
+
+        auto window = eqx::ogl::Window{ 1920, 1080,
+            "eqx::ogl --- Test Tile_Map"sv };
+        auto shader_program = eqx::ogl::Shader_Program::from_files(
+            "./Resources/Shaders/MGame/Vertex.glsl"sv,
+            "./Resources/Shaders/MGame/Fragment.glsl"sv);
+        const auto texels = make_atlas();
+        const auto atlas = eqx::ogl::Texture{
+            eqx::ogl::Texel_View{ texels, 64, 16, 4 } };
+        auto samplers = eqx::ogl::Sampler_Cache{};
+
+        // Tile (0, 0) is the bottom left corner, the camera starts looking
+        // at the top left one.
+        auto tile_map = eqx::ogl::Tile_Map{ size, size, tile_size, atlas,
+            4, 1, eqx::lib::Point<float>{ 0.0F, -size * tile_size } };
+        auto rng = std::mt19937{ 42u };
+        for (auto y = 0; y < size; ++y)
+        {
+            for (auto x = 0; x < size; ++x)
+            {
+                tile_map.set_tile(x, y, static_cast<std::uint16_t>(
+                    (x / 8 + y / 8 + static_cast<int>(rng() % 2u)) % 4));
+            }
+        }
+
+        shader_program.set_mat4("u_proj"sv,
+            glm::ortho(0.0f, 1920.0f, -1080.0f, 0.0f));
+        shader_program.activate_texture("u_tex0"sv, 0);
+
+        auto camera = eqx::lib::Point<float>{};
+        auto rebuilds = 0ull;
+        auto unexpected = 0ull;
+        auto frame_timer = eqx::ogl::Frame_Timer{};
+        while (!window.should_close())
+        {
+            window.clear();
+
+            window.set_name(std::format(
+                "eqx::ogl --- "sv
+                "Test Tile_Map --- "sv
+                "Chunks: {} / {} --- "sv
+                "Rebuilds: {} --- "sv
+                "Frames: {} --- "sv
+                "FPS: {}"sv,
+                tile_map.get_drawn(), tile_map.get_chunk_count(),
+                tile_map.get_rebuilds(), frame_timer.get_frames(),
+                frame_timer.get_fps()));
+
+            const auto speed = 20.0F;
+            const auto previous = camera;
+            camera.set_x(camera.get_x()
+                + (window.key_down(eqx::ogl::Window::Key::D) ? speed : 0.0F)
+                - (window.key_down(eqx::ogl::Window::Key::A) ? speed : 0.0F));
+            camera.set_y(camera.get_y()
+                + (window.key_down(eqx::ogl::Window::Key::W) ? speed : 0.0F)
+                - (window.key_down(eqx::ogl::Window::Key::S) ? speed : 0.0F));
+
+            // Clicking cycles the tile under the cursor, only its chunk is
+            // rebuilt on the next draw.
+            auto edited = false;
+            if (window.mouse_button_down(
+                eqx::ogl::Window::Mouse_Button::Left))
+            {
+                const auto world = eqx::lib::Point<float>::translate(camera,
+                    window.get_cursor_location());
+                const auto x = static_cast<int>(
+                    std::floor(world.get_x() / tile_size));
+                const auto y = static_cast<int>(std::floor(
+                    (world.get_y() + size * tile_size) / tile_size));
+                if (x >= 0 && x < size && y >= 0 && y < size)
+                {
+                    tile_map.set_tile(x, y, static_cast<std::uint16_t>(
+                        (tile_map.get_tile(x, y) + 1) % 4));
+                    edited = true;
+                }
+            }
+
+            shader_program.set_mat4("u_view"sv, glm::translate(
+                glm::mat4{ 1.0f },
+                glm::vec3{ -camera.get_x(), -camera.get_y(), 0.0f }));
+            shader_program.enable();
+            const auto before = tile_map.get_rebuilds();
+            tile_map.draw(eqx::ogl::Aabb{ camera.get_x(),
+                camera.get_y() - 1080.0F, camera.get_x() + 1920.0F,
+                camera.get_y() },
+                samplers.get(eqx::ogl::Sampler_State::nearest()));
+            if (frame_timer.get_frames() > 0ull)
+            {
+                // Chunks are built once on the first frame, after that only
+                // an edit or new chunks scrolling into view may rebuild.
+                const auto delta = tile_map.get_rebuilds() - before;
+                rebuilds += delta;
+                if (!edited && camera.get_x() == previous.get_x()
+                    && camera.get_y() == previous.get_y())
+                {
+                    unexpected += delta;
+                }
+            }
+
+            if (window.key_down(eqx::ogl::Window::Key::Escape))
+            {
+                window.close();
+            }
+
+            if constexpr (c_smoke == true)
+            {
+                if (frame_timer.get_frames() > 0ull)
+                {
+                    window.close();
+                }
+            }
+
+            frame_timer.update();
+            window.swap();
+            window.poll();
+        }
+
+        const auto stats = frame_timer.get_stats();
+        std::format_to(std::ostream_iterator<char>(std::cout),
+            "{}x{} tiles in {} chunks, {} drawn last frame\n"sv
+            "{} rebuilds in total, {} after the first frame, "sv
+            "{} unexpected\n"sv
+            "p50: {:.3f}ms p99: {:.3f}ms max: {:.3f}ms\n"sv,
+            size, size, tile_map.get_chunk_count(), tile_map.get_drawn(),
+            tile_map.get_rebuilds(), rebuilds, unexpected,
+            stats.p50, stats.p99, stats.max);
+
+        ok = unexpected == 0ull && tile_map.get_rebuilds() > 0ull;
+    }
+
+    eqx::ogl::free();
+
+    if (!ok)
+    {
+        std::format_to(std::ostream_iterator<char>(std::cerr),
+            "Unchanged chunks were rebuilt\n"sv);
+        return EXIT_FAILURE;
+    }
+
+    std::format_to(std::ostream_iterator<char>(std::cout), "\nEnd\n"sv);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,185 @@
+// Main.cpp
+
+import <Eqx/std.hpp>;
+import <Eqx/TPL/glad/glad.hpp>;
+import <Eqx/TPL/glm/glm.hpp>;
+import Eqx.Lib;
+import Eqx.OGL.Window;
+import Eqx.OGL.Shader_Program;
+import Eqx.OGL.Vertex_Array;
+import Eqx.OGL.Texture;
+import Eqx.OGL.Upload_Worker;
+
+using namespace std::literals;
+
+#ifdef EQX_SMOKE
+    constexpr auto c_smoke = true;
+#else
+    constexpr auto c_smoke = false;
+#endif // EQX_SMOKE
+
+int main([[maybe_unused]] int argc, [[maybe_unused]] char* argv[])
+{
+    std::format_to(std::ostream_iterator<char>(std::cout), "Start\n\n"sv);
+
+    eqx::ogl::init();
+
+    constexpr auto paths = std::array<std::string_view, 8>{
+        "./Resources/Textures/Box.png"sv,
+        "./Resources/Textures/Brick_Wall.png"sv,
+        "./Resources/Textures/M4_Sherman_Hull.png"sv,
+        "./Resources/Textures/M4_Sherman_Turret.png"sv,
+        "./Resources/Textures/Panzer3_Destroyed.png"sv,
+        "./Resources/Textures/Panzer3_Hull.png"sv,
+        "./Resources/Textures/Panzer3_Turret.png"sv,
+        "./Resources/Textures/TankShell.png"sv };
+
+    auto loc = eqx::lib::Point<float>{};
+    auto window = eqx::ogl::Window{ 1920, 1080,
+        "eqx::ogl --- Test Upload_Worker"sv };
+    auto shader_program = eqx::ogl::Shader_Program::from_files(
+        "./Resources/Shaders/Texture/Vertex.glsl"sv,
+        "./Resources/Shaders/Texture/Fragment.glsl"sv);
+    auto vertex_array = eqx::ogl::Vertex_Array{
+        std::array<float, 16>{
+            0.5f, 0.5f, 1.0f, 0.0f,
+            -0.5f, 0.5f, 0.0f, 0.0f,
+            0.5f, -0.5f, 1.0f, 1.0f,
+            -0.5f, -0.5f, 0.0f, 1.0f },
+        std::array<unsigned int, 2>{ 2u, 2u },
+        std::array<unsigned int, 6>{
+            0u, 1u, 2u,
+            1u, 3u, 2u } };
+
+    shader_program.set_mat4("u_view"sv, glm::mat4{ 1.0f });
+    shader_program.set_mat4("u_proj"sv,
+        glm::ortho(0.0f, 1920.0f, -1080.0f, 0.0f));
+    shader_program.activate_texture("u_tex0"sv, 0);
+
+    // Textures are decoded and uploaded on the worker, the main loop only
+    // starts drawing one once its fence has signalled.
+    auto textures =
+        std::vector<std::optional<eqx::ogl::Texture>>(std::ranges::size(paths));
+    auto ready = std::vector<bool>(std::ranges::size(paths), false);
+    auto upload_worker = eqx::ogl::Upload_Worker{ window };
+
+    // A generated texture the main context reads back once it is ready.
+    constexpr auto pattern_width = 37;
+    constexpr auto pattern_height = 19;
+    auto pattern = std::vector<unsigned char>(
+        static_cast<std::size_t>(pattern_width * pattern_height * 4));
+    for (auto i = std::size_t{ 0 }; i < std::ranges::size(pattern); ++i)
+    {
+        pattern[i] = static_cast<unsigned char>(i * 7u + i / 4u);
+    }
+    auto pattern_texture = std::optional<eqx::ogl::Texture>{};
+    auto pattern_ready = false;
+    upload_worker.submit(
+        [&pattern_texture, &pattern]() noexcept
+        {
+            pattern_texture.emplace(eqx::ogl::Texel_View{ pattern,
+                pattern_width, pattern_height, 4 });
+        },
+        [&pattern_ready]() noexcept
+        {
+            pattern_ready = true;
+        });
+
+    for (auto i = std::size_t{ 0 }; i < std::ranges::size(paths); ++i)
+    {
+        upload_worker.submit(
+            [&textures, &paths, i]() noexcept
+            {
+                textures[i].emplace(std::filesystem::path{ paths[i] });
+            },
+            [&ready, i]() noexcept
+            {
+                ready[i] = true;
+            });
+    }
+
+    auto frame_timer = eqx::ogl::Frame_Timer{};
+    while (!window.should_close())
+    {
+        window.clear();
+
+        loc = window.get_cursor_location();
+        window.set_name(std::format(
+            "eqx::ogl --- "sv
+            "Test Upload_Worker --- "sv
+            "Pending: {} --- "sv
+            "Frames: {} --- "sv
+            "FPS: {}"sv,
+            upload_worker.get_pending(), frame_timer.get_frames(),
+            frame_timer.get_fps()));
+
+        upload_worker.poll();
+        if constexpr (c_smoke == true)
+        {
+            upload_worker.finish();
+        }
+
+        shader_program.enable();
+        vertex_array.enable();
+        for (auto i = std::size_t{ 0 }; i < std::ranges::size(paths); ++i)
+        {
+            if (!ready[i])
+            {
+                continue;
+            }
+
+            auto model = glm::translate(glm::mat4{ 1.0f },
+                glm::vec3{ loc.get_x() + static_cast<float>(i) * 110.0f,
+                    loc.get_y(), 0.0f });
+            model = glm::scale(model, glm::vec3{ 100.0f, 100.0f, 1.0f });
+            shader_program.set_mat4("u_model"sv, model);
+            textures[i]->enable(0);
+            eqx::ogl::draw(vertex_array.get_index_count());
+        }
+
+        if (window.key_down(eqx::ogl::Window::Key::Escape))
+        {
+            window.close();
+        }
+
+        if constexpr (c_smoke == true)
+        {
+            window.close();
+        }
+
+        frame_timer.update();
+        window.swap();
+        window.poll();
+    }
+
+    const auto stats = frame_timer.get_stats();
+    std::format_to(std::ostream_iterator<char>(std::cout),
+        "p50: {:.3f}ms p99: {:.3f}ms max: {:.3f}ms\n"sv,
+        stats.p50, stats.p99, stats.max);
+
+    upload_worker.finish();
+
+    auto texels = std::vector<unsigned char>(std::ranges::size(pattern));
+    pattern_texture->enable(0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+    const auto ok = pattern_ready && texels == pattern
+        && std::ranges::all_of(ready, std::identity{});
+
+    pattern_texture.reset();
+    textures.clear();
+    shader_program.free();
+    vertex_array.free();
+    window.free();
+    eqx::ogl::free();
+
+    if (!ok)
+    {
+        std::format_to(std::ostream_iterator<char>(std::cerr),
+            "Uploaded texels did not read back as expected\n"sv);
+        return EXIT_FAILURE;
+    }
+
+    std::format_to(std::ostream_iterator<char>(std::cout), "\nEnd\n"sv);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,84 @@
+// Main.cpp
+
+import <Eqx/std.hpp>;
+import Eqx.OGL.Pack;
+
+using namespace std::literals;
+
+/*
+ * Usage: Eqx_OGL_Packer <output> <root> [--tiles <size>] <files...>
+ *
+ * Every file is given relative to <root> and is stored under that relative
+ * path, so "./Resources/Textures/Box.png" packed with root "./Resources"
+ * becomes "Textures/Box.png". Images after --tiles are packed as tiled
+ * textures with tiles of <size> texels, for Tiled_Texture to stream.
+ */
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        std::format_to(std::ostream_iterator<char>(std::cerr),
+            "Usage: {} <output> <root> <files...>\n"sv, argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    const auto output = std::filesystem::path{ argv[1] };
+    const auto root = std::filesystem::path{ argv[2] };
+
+    auto writer = eqx::ogl::Pack_Writer{};
+    auto tile_size = std::uint32_t{ 0 };
+    for (auto i = 3; i < argc; ++i)
+    {
+        if (argv[i] == "--tiles"sv)
+        {
+            const auto arg = i + 1 < argc ? std::string_view{ argv[i + 1] }
+                : std::string_view{};
+            const auto [end, error] = std::from_chars(std::ranges::data(arg),
+                std::ranges::data(arg) + std::ranges::size(arg), tile_size);
+            if (error != std::errc{} || end != std::ranges::data(arg)
+                + std::ranges::size(arg) || tile_size == 0u)
+            {
+                std::format_to(std::ostream_iterator<char>(std::cerr),
+                    "--tiles needs a positive tile size\n"sv);
+                return EXIT_FAILURE;
+            }
+
+            ++i;
+            continue;
+        }
+
+        const auto name = std::filesystem::path{ argv[i] }.generic_string();
+        const auto path = root / argv[i];
+        const auto ext = path.extension();
+
+        if ((ext == ".png"sv || ext == ".jpg"sv) && tile_size > 0u)
+        {
+            writer.add_tiled_texture(name, path, tile_size);
+        }
+        else if (ext == ".png"sv || ext == ".jpg"sv)
+        {
+            writer.add_texture(name, path);
+        }
+        else if (ext == ".glsl"sv)
+        {
+            writer.add_shader(name, path);
+        }
+        else
+        {
+            writer.add_raw(name, path);
+        }
+
+        std::format_to(std::ostream_iterator<char>(std::cout),
+            "Packed {}\n"sv, name);
+    }
+
+    writer.write(output);
+    if (!eqx::ogl::Pack{ output }.valid())
+    {
+        std::format_to(std::ostream_iterator<char>(std::cerr),
+            "{} could not be read back\n"sv, output.string());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}